@@ -0,0 +1,299 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include "TimerWheel.h"
+#include "TextureAtlas.h"
+
+// Every sprite sheet an animation clip can reference
+enum class TextureId : uint8_t {
+    PlayerSheet,
+    PlayerIdle,
+    PlayerDeath,
+    SlimeIdle,
+    SlimeWalk,
+    SlimeAttack,
+    SlimeHurt,
+    SlimeDeath,
+    GoblinIdle,
+    GoblinWalk,
+    GoblinAttack,
+    GoblinHurt,
+    GoblinDeath,
+    SkeletonSwordman,
+    Count
+};
+
+const size_t TEXTURE_COUNT = static_cast<size_t>(TextureId::Count);
+
+constexpr const char* TEXTURE_PATHS[TEXTURE_COUNT] = {
+    "Assets/Player/Textures/spritesheet2.png",
+    "Assets/Player/Textures/Idle/idle_down.png",
+    "Assets/Player/Textures/Death/death_normal_down.png",
+    "Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_idle_shadowless.png",
+    "Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_walk_shadowless.png",
+    "Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_attack_shadowless.png",
+    "Assets/Enemy/Slime/Blue Slime/Textures/spr_Blue_slime_hurt.png",
+    "Assets/Enemy/Slime/Blue Slime/Textures/spr_Blue_slime_death.png",
+    "Assets/Enemy/Golbin/Textures/spr_goblin_idle.png",
+    "Assets/Enemy/Golbin/Textures/spr_goblin_walk.png",
+    "Assets/Enemy/Golbin/Textures/spr_goblin_attack.png",
+    "Assets/Enemy/Golbin/Textures/spr_goblin_hurt.png",
+    "Assets/Enemy/Golbin/Textures/spr_goblin_death.png",
+    "Assets/Enemy/Skeleton/Textures/blpixelartist_Skeleton Army/Skeleton_Swordman Not Armored.png",
+};
+
+// Resolves each sprite sheet to its region in the sprite atlas; entities share them by
+// TextureId. Sheets missing from the atlas fall back to an empty texture.
+class TextureLibrary {
+public:
+    TextureLibrary() {
+        regions_.fill(AtlasRegion{ &missing_, sf::IntRect() });
+    }
+
+    TextureLibrary(const TextureLibrary&) = delete;
+    TextureLibrary& operator=(const TextureLibrary&) = delete;
+
+    bool bind(const TextureAtlas& atlas) {
+        bool allFound = true;
+        for (size_t i = 0; i < TEXTURE_COUNT; ++i) {
+            AtlasRegion region = atlas.find(TEXTURE_PATHS[i]);
+            if (!region.isValid()) {
+                std::cout << "Sprite sheet missing from atlas: " << TEXTURE_PATHS[i] << std::endl;
+                region = AtlasRegion{ &missing_, sf::IntRect() };
+                allFound = false;
+            }
+            regions_[i] = region;
+        }
+        return allFound;
+    }
+
+    const AtlasRegion& get(TextureId id) const { return regions_[static_cast<size_t>(id)]; }
+
+private:
+    sf::Texture missing_;
+    std::array<AtlasRegion, TEXTURE_COUNT> regions_;
+};
+
+enum class PlayMode : uint8_t { Loop, Once };
+
+// One row of a sprite sheet played at a fixed rate
+struct AnimationClip {
+    TextureId texture;
+    int row;
+    int frameCount;
+    uint16_t frameTicks; // Duration of one frame in simulation ticks
+    PlayMode mode;
+    sf::Vector2i frameSize;
+};
+
+constexpr uint16_t frameTicks(float seconds) {
+    return static_cast<uint16_t>(seconds * SIM_TICK_RATE + 0.5f) < 1 ? 1
+        : static_cast<uint16_t>(seconds * SIM_TICK_RATE + 0.5f);
+}
+
+// Player clips. spritesheet2.png rows: walk down/left/up/right = 0/1/3/5,
+// attack down/left/right/up = 2/4/8/10, dash down/left/right/up = 6/7/11/9.
+enum class Facing : uint8_t { Down, Left, Right, Up, Count };
+enum class PlayerAction : uint8_t { Walk, Attack, Dash, Count };
+
+constexpr AnimationClip makePlayerClip(int row, int frameCount, float seconds) {
+    return { TextureId::PlayerSheet, row, frameCount, frameTicks(seconds), PlayMode::Loop, { 48, 64 } };
+}
+
+constexpr AnimationClip PLAYER_CLIPS[static_cast<size_t>(PlayerAction::Count)][static_cast<size_t>(Facing::Count)] = {
+    // Down, Left, Right, Up
+    { makePlayerClip(0, 8, 0.1f), makePlayerClip(1, 8, 0.1f), makePlayerClip(5, 8, 0.1f), makePlayerClip(3, 8, 0.1f) },   // Walk
+    { makePlayerClip(2, 6, 0.1f), makePlayerClip(4, 6, 0.1f), makePlayerClip(8, 6, 0.1f), makePlayerClip(10, 6, 0.1f) },  // Attack
+    { makePlayerClip(6, 8, 0.08f), makePlayerClip(7, 8, 0.08f), makePlayerClip(11, 8, 0.08f), makePlayerClip(9, 8, 0.08f) }, // Dash
+};
+
+constexpr const AnimationClip& playerClip(PlayerAction action, Facing facing) {
+    return PLAYER_CLIPS[static_cast<size_t>(action)][static_cast<size_t>(facing)];
+}
+
+constexpr AnimationClip PLAYER_IDLE_CLIP = { TextureId::PlayerIdle, 0, 4, frameTicks(0.2f), PlayMode::Loop, { 48, 64 } };
+constexpr AnimationClip PLAYER_DEATH_CLIP = { TextureId::PlayerDeath, 0, 6, frameTicks(0.1f), PlayMode::Once, { 48, 64 } };
+
+// Enemy clips, indexed by enemy kind then state (Idle, Walk, Attack, Hurt, Dead)
+enum class EnemyKind : uint8_t { Slime, Goblin, Skeleton, Count };
+const size_t ENEMY_STATE_COUNT = 5;
+
+constexpr AnimationClip makeEnemyClip(TextureId texture, int frameCount, float seconds, PlayMode mode) {
+    return { texture, 0, frameCount, frameTicks(seconds), mode, { 64, 64 } };
+}
+
+// A sheet that is a single picture, held for the whole state
+constexpr AnimationClip makeStillEnemyClip(TextureId texture, sf::Vector2i frameSize, float seconds, PlayMode mode) {
+    return { texture, 0, 1, frameTicks(seconds), mode, frameSize };
+}
+
+constexpr AnimationClip ENEMY_CLIPS[static_cast<size_t>(EnemyKind::Count)][ENEMY_STATE_COUNT] = {
+    { // Slime
+        makeEnemyClip(TextureId::SlimeIdle, 6, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::SlimeWalk, 6, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::SlimeAttack, 15, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::SlimeHurt, 4, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::SlimeDeath, 6, 0.1f, PlayMode::Once),
+    },
+    { // Goblin: attack plays once at double speed, then the goblin returns to idle
+        makeEnemyClip(TextureId::GoblinIdle, 4, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::GoblinWalk, 4, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::GoblinAttack, 14, 0.05f, PlayMode::Once),
+        makeEnemyClip(TextureId::GoblinHurt, 4, 0.1f, PlayMode::Loop),
+        makeEnemyClip(TextureId::GoblinDeath, 4, 0.1f, PlayMode::Once),
+    },
+    { // Skeleton: the Skeleton Army art has one frame per unit, so every state shows it
+        makeStillEnemyClip(TextureId::SkeletonSwordman, { 40, 33 }, 0.1f, PlayMode::Loop),
+        makeStillEnemyClip(TextureId::SkeletonSwordman, { 40, 33 }, 0.1f, PlayMode::Loop),
+        makeStillEnemyClip(TextureId::SkeletonSwordman, { 40, 33 }, 0.5f, PlayMode::Once),
+        makeStillEnemyClip(TextureId::SkeletonSwordman, { 40, 33 }, 0.1f, PlayMode::Loop),
+        makeStillEnemyClip(TextureId::SkeletonSwordman, { 40, 33 }, 0.1f, PlayMode::Once),
+    },
+};
+
+// Playback state of one sprite
+struct Animator {
+    const AnimationClip* clip = nullptr;
+    int frame = 0;
+    uint16_t ticksInFrame = 0;
+    bool finished = false;
+    bool clipChanged = false;  // Sheet changed; the sprite may need a different atlas page
+    bool frameChanged = false; // Texture rect needs updating
+    bool active = false;
+};
+
+// Owns every Animator and advances them all in one pass per simulation tick.
+// Entities hold an AnimatorHandle, pick clips with play() and push the result onto
+// their sprite with apply(), which only touches the sprite when something changed.
+class AnimationSystem {
+public:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    explicit AnimationSystem(const TextureLibrary& textures) : textures_(textures) {}
+
+    AnimationSystem(const AnimationSystem&) = delete;
+    AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+    uint32_t acquire() {
+        uint32_t index;
+        if (!freeList_.empty()) {
+            index = freeList_.back();
+            freeList_.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(animators_.size());
+            animators_.emplace_back();
+        }
+        animators_[index] = Animator();
+        animators_[index].active = true;
+        return index;
+    }
+
+    void release(uint32_t index) {
+        animators_[index].active = false;
+        freeList_.push_back(index);
+    }
+
+    // Switch to a clip; replaying the current clip keeps its progress unless restart is set
+    void play(uint32_t index, const AnimationClip& clip, bool restart = false) {
+        Animator& animator = animators_[index];
+        if (animator.clip == &clip && !restart) return;
+        if (animator.clip == nullptr || animator.clip->texture != clip.texture) {
+            animator.clipChanged = true;
+        }
+        animator.clip = &clip;
+        animator.frame = 0;
+        animator.ticksInFrame = 0;
+        animator.finished = false;
+        animator.frameChanged = true;
+    }
+
+    void update() {
+        for (Animator& animator : animators_) {
+            if (!animator.active || animator.clip == nullptr || animator.finished) continue;
+
+            if (++animator.ticksInFrame < animator.clip->frameTicks) continue;
+            animator.ticksInFrame = 0;
+
+            if (animator.frame + 1 < animator.clip->frameCount) {
+                ++animator.frame;
+                animator.frameChanged = true;
+            }
+            else if (animator.clip->mode == PlayMode::Loop) {
+                animator.frame = 0;
+                animator.frameChanged = true;
+            }
+            else {
+                animator.finished = true; // Hold the last frame
+            }
+        }
+    }
+
+    void apply(uint32_t index, sf::Sprite& sprite) {
+        Animator& animator = animators_[index];
+        if (animator.clip == nullptr) return;
+        const AtlasRegion& region = textures_.get(animator.clip->texture);
+        if (animator.clipChanged) {
+            if (&sprite.getTexture() != region.page) {
+                sprite.setTexture(*region.page);
+            }
+            animator.clipChanged = false;
+        }
+        if (animator.frameChanged) {
+            const sf::Vector2i& size = animator.clip->frameSize;
+            sf::Vector2i framePosition(animator.frame * size.x, animator.clip->row * size.y);
+            sprite.setTextureRect(sf::IntRect(region.rect.position + framePosition, size));
+            animator.frameChanged = false;
+        }
+    }
+
+    const Animator& get(uint32_t index) const { return animators_[index]; }
+
+private:
+    const TextureLibrary& textures_;
+    std::vector<Animator> animators_;
+    std::vector<uint32_t> freeList_;
+};
+
+// Entity-owned slot in an AnimationSystem
+class AnimatorHandle {
+public:
+    explicit AnimatorHandle(AnimationSystem& system) : system_(&system), index_(system.acquire()) {}
+    ~AnimatorHandle() { reset(); }
+
+    AnimatorHandle(const AnimatorHandle&) = delete;
+    AnimatorHandle& operator=(const AnimatorHandle&) = delete;
+
+    AnimatorHandle(AnimatorHandle&& other) noexcept : system_(other.system_), index_(other.index_) {
+        other.index_ = AnimationSystem::NONE;
+    }
+    AnimatorHandle& operator=(AnimatorHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            system_ = other.system_;
+            index_ = other.index_;
+            other.index_ = AnimationSystem::NONE;
+        }
+        return *this;
+    }
+
+    void play(const AnimationClip& clip, bool restart = false) { system_->play(index_, clip, restart); }
+    void apply(sf::Sprite& sprite) { system_->apply(index_, sprite); }
+    bool isFinished() const { return system_->get(index_).finished; }
+    bool isPlaying(const AnimationClip& clip) const { return system_->get(index_).clip == &clip; }
+
+private:
+    void reset() {
+        if (index_ != AnimationSystem::NONE) {
+            system_->release(index_);
+            index_ = AnimationSystem::NONE;
+        }
+    }
+
+    AnimationSystem* system_;
+    uint32_t index_;
+};
@@ -5,11 +5,61 @@
 #include <cmath>
 #include <iostream>
 #include "MapManager.h"
+#include "TimerWheel.h"
+#include "Animation.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "AssetManifest.h"
+#include "Camera.h"
+#include "LevelLoader.h"
+#include "SpawnTable.h"
+#include "WaveScheduler.h"
+#include "StartupLoader.h"
+#include "Random.h"
+#include "Input.h"
+#include "InputSampler.h"
+#include "Replay.h"
+#include "FrameStats.h"
+#include "Counters.h"
+#include "FrameArena.h"
+#include "Log.h"
+#include "Hud.h"
+#include "WorldRenderTarget.h"
+#include "FrameHandoff.h"
+#include "DepthSort.h"
+#include "FramePacer.h"
 #include <filesystem>
 #include <unordered_map>
 #include <vector>
 #include <optional>
 #include <list>
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <functional>
+#include <charconv>
+#include <cstring>
+#include <type_traits>
+
+#if ASHVALE_PROFILING
+// Every heap allocation goes through here, for the "heap allocs" and "heap bytes" counters.
+// new[], delete[] and the nothrow forms forward to these.
+void* operator new(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    heapAllocationBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+#endif
 
 class Player;
 class Enemy;
@@ -17,6 +67,58 @@ class Enemy;
 void updateHitBox(Player& player, Enemy& enemy);
 void updateHealing(Player& player);
 
+// Global timer wheel, advanced once per simulation tick. Entity timers live here.
+TimerWheel simTimers;
+
+// Tilesheets, entity sheets, weapon icons and HUD images all live in this atlas
+TextureAtlas spriteAtlas;
+
+// Shared sprite sheets and the animation system that steps every animator
+TextureLibrary textures;
+AnimationSystem animations(textures);
+
+// Simulation state beyond the entities themselves: the seeded RNG, the tick count, which
+// screen the game is on and the enemies. World::step advances it one tick from an
+// InputFrame without touching the window, clocks or input devices, so the same seed and
+// inputs always give the same game. The player, map and timer wheel stay file-scope
+// because Player and Enemy reach them directly.
+struct World {
+    enum class Screen { Title, Playing, LevelCleared, GameOver, ToBeContinued };
+
+    Random random;
+    uint64_t tick = 0;              // Gameplay ticks stepped (title and transition screens excluded)
+    Screen screen = Screen::Title;
+    bool quitRequested = false;     // Confirm pressed on a final screen
+    bool waitForStreaming = false;  // Block on chunk streaming; keeps streamed maps deterministic
+    std::list<Enemy> enemies;
+    WaveScheduler waves;            // Lets the level's enemies in from the pool
+
+    // Every enemy of the level not let in yet, by kind, built when the level starts. Letting
+    // one in is a splice into enemies: no construction or allocation mid-level.
+    std::array<std::list<Enemy>, static_cast<size_t>(EnemyKind::Count)> enemyPool;
+
+    // Tiles the current level's enemies may spawn on, and where the opening wave goes
+    SpawnTable spawnTable;
+    std::vector<sf::Vector2f> openingSpawnPoints;
+    size_t openingSpawnsUsed = 0;
+
+    // Recent work per frame over the frame period, from the profiler; above 1 waves spawn
+    // more slowly.
+    // Left at 0 when a run has to be reproducible (recording, replay, headless).
+    double frameLoad = 0.0;
+
+    // Optional: reads the held buttons again right before the player moves, so they are as
+    // fresh as they can be. lastInput is what the step actually ran with, for recording.
+    std::function<uint8_t()> resampleHeld;
+    InputFrame lastInput;
+
+    void step(const InputFrame& input);
+
+    // Hash of the player and enemy state, to compare runs
+    uint64_t checksum() const;
+};
+extern World world; // Defined once Enemy is complete
+
 // SFX class to handle all audio-related functionality
 class SFX {
 private:
@@ -36,15 +138,15 @@ public:
     void initializeAudio()
     {
         // Load both background and critical theme music at the start
-        if (!backgroundMusic.openFromFile("Assets/SoundTracks/PitcherPerfectTheme.wav")) 
+        if (!openMusicAsset(backgroundMusic, "Assets/SoundTracks/PitcherPerfectTheme.wav")) 
         {
-            std::cerr << "Failed to load background music!" << std::endl;
+            LOG_ERROR(LogCategory::Audio, "Failed to load background music!");
             return;
         }
         
-        if (!criticalThemeMusic.openFromFile("Assets/SoundTracks/CriticalTheme.wav")) 
+        if (!openMusicAsset(criticalThemeMusic, "Assets/SoundTracks/CriticalTheme.wav")) 
         {
-            std::cerr << "Failed to load critical theme music!" << std::endl;
+            LOG_ERROR(LogCategory::Audio, "Failed to load critical theme music!");
             return;
         }
         
@@ -58,7 +160,7 @@ public:
         // Start playing background music
         backgroundMusic.play();
         musicLoaded = true;
-        std::cout << "Audio system initialized successfully" << std::endl;
+        LOG_INFO(LogCategory::Audio, "Audio system initialized successfully");
     }
     
     void playCriticalTheme() 
@@ -67,7 +169,7 @@ public:
         
         if (!criticalMusicPlaying) 
         {
-            std::cout << "Switching to critical theme" << std::endl;
+            LOG_DEBUG(LogCategory::Audio, "Switching to critical theme");
             backgroundMusic.pause();
             criticalThemeMusic.play();
             criticalMusicPlaying = true;
@@ -78,7 +180,7 @@ public:
         if (!musicLoaded) return;
         
         if (criticalMusicPlaying) {
-            std::cout << "Switching to background music" << std::endl;
+            LOG_DEBUG(LogCategory::Audio, "Switching to background music");
             criticalThemeMusic.stop();
             backgroundMusic.play();
             criticalMusicPlaying = false;
@@ -89,7 +191,7 @@ public:
         if (!musicLoaded) return;
         
         enemiesDetectingPlayer++;
-        std::cout << "Enemy detected player. Total detecting: " << enemiesDetectingPlayer << std::endl;
+        LOG_DEBUG(LogCategory::Audio, "Enemy detected player. Total detecting: {}", enemiesDetectingPlayer);
         
         // Always switch to critical theme when an enemy detects the player
         playCriticalTheme();
@@ -101,7 +203,7 @@ public:
         enemiesDetectingPlayer--;
         if (enemiesDetectingPlayer < 0) enemiesDetectingPlayer = 0;
         
-        std::cout << "Enemy lost sight of player. Total detecting: " << enemiesDetectingPlayer << std::endl;
+        LOG_DEBUG(LogCategory::Audio, "Enemy lost sight of player. Total detecting: {}", enemiesDetectingPlayer);
         
         // Only switch back to background music if no enemies are detecting
         if (enemiesDetectingPlayer == 0) {
@@ -123,30 +225,28 @@ SFX sfx;
 // Remove global sword variables and add Weapon class
 class Weapon {
 private:
-    sf::Texture texture;
     std::optional<sf::Sprite> sprite;
     float scale;
     sf::Vector2f offset;
     float swingAngle = 0.f;
     bool swinging = false;
-    sf::Clock swingClock;
+    uint64_t swingStartTick = 0;
     float swingDuration = 0.25f; // seconds for the swing 
 
 public:
-    Weapon(const std::string& texturePath, float scale = 1.0f) : scale(scale), offset(0.f, 0.f) {
-        // First load the texture
-        if (!texture.loadFromFile(texturePath)) {
+    Weapon(const AtlasRegion& region, float scale = 1.0f) : scale(scale), offset(0.f, 0.f) {
+        // The icon lives in the sprite atlas
+        if (!region.isValid()) {
 
-            std::cerr << "Failed to load weapon texture from: " << texturePath << std::endl;
+            LOG_ERROR(LogCategory::Assets, "Weapon texture missing from sprite atlas!");
         }
         else {
-            std::cout << "Weapon texture loaded successfully!" << std::endl;
-            std::cout << "Weapon texture size: " << texture.getSize().x << "x" << texture.getSize().y << std::endl;
+            LOG_DEBUG(LogCategory::Assets, "Weapon texture size: {}x{}", region.rect.size.x, region.rect.size.y);
 
-            // Create and set up the sprite after texture is loaded
-            sprite.emplace(texture);
+            // Create and set up the sprite from its atlas region
+            sprite.emplace(*region.page, region.rect);
             sprite->setScale(sf::Vector2f(scale, scale));
-            sprite->setOrigin(sf::Vector2f(texture.getSize().x / 2.f, texture.getSize().y / 2.f));
+            sprite->setOrigin(sf::Vector2f(region.rect.size.x / 2.f, region.rect.size.y / 2.f));
             /*
             // Debug output
             std::cout << "Sprite scale: " << sprite->getScale().x << "x" << sprite->getScale().y << std::endl;
@@ -171,9 +271,9 @@ public:
         */
     }
 
-    void draw(sf::RenderWindow& window) {
+    void draw(SpriteBatch& batch) {
         if (sprite.has_value()) {
-            window.draw(*sprite);
+            batch.draw(*sprite);
         }
     }
 
@@ -187,10 +287,10 @@ public:
     void updateSwing(bool isAttacking) {
         if (isAttacking && !swinging) {
             swinging = true;
-            swingClock.restart();
+            swingStartTick = simTimers.now();
         }
         if (swinging) {
-            float t = swingClock.getElapsedTime().asSeconds() / swingDuration;
+            float t = static_cast<float>(simTimers.now() - swingStartTick) / secondsToTicks(swingDuration);
             if (t < 1.f) {
                 // Swing from -45 to +45 degrees and back to 0
                 swingAngle = std::sin(t * 3.14159f) * 45.f;
@@ -220,6 +320,20 @@ public:
 // Global MapManager instance
 MapManager mapManager("Assets/maps");
 
+// Builds the next level in the background during the "LEVEL CLEARED" screen
+LevelLoader levelLoader(mapManager);
+const sf::Vector2f PLAYER_START_POSITION(100.f, 100.f);
+
+// Follows the player; the window shows one 1280x720 slice of the map
+Camera camera({ 1280.f, 720.f });
+
+// Centre the camera on the player and, for streamed maps, wait for the chunks around them
+void focusCameraOnPlayer() {
+    sf::FloatRect playerBounds = playerSprite.getGlobalBounds();
+    camera.follow(playerBounds.position + playerBounds.size / 2.f, mapManager.getMapPixelSize());
+    mapManager.streamIn(camera.getVisibleArea());
+}
+
 // A* Pathfinding Implementation
 struct Node {
     int x, y;
@@ -242,22 +356,35 @@ struct NodeHash {
 
 class PathFinder {
 public:
-    static std::vector<sf::Vector2f> findPath(const MapManager& mapManager,
+    // Writes the path (tile centres, start to goal) into path, reusing its capacity; leaves
+    // it empty when there is none. The search itself runs in the frame arena.
+    static void findPath(const MapManager& mapManager,
         sf::Vector2f start,
-        sf::Vector2f goal) {
+        sf::Vector2f goal,
+        std::vector<sf::Vector2f>& path) {
+        PROFILE_ZONE("findPath");
+        COUNTER_ADD("paths requested", 1);
+
         // Convert positions to tile coordinates
         int startX = static_cast<int>(start.x / SCALED_TILE_SIZE);
         int startY = static_cast<int>(start.y / SCALED_TILE_SIZE);
         int goalX = static_cast<int>(goal.x / SCALED_TILE_SIZE);
         int goalY = static_cast<int>(goal.y / SCALED_TILE_SIZE);
+        path.clear();
+
+        // Goals in another region can never be reached; skip the search
+        if (!mapManager.isReachable({ startX, startY }, { goalX, goalY })) {
+            return;
+        }
 
         // Create start and goal nodes
         Node startNode{ startX, startY };
         Node goalNode{ goalX, goalY };
 
         // Initialize open and closed sets
-        std::vector<Node> openSet;
-        std::unordered_map<Node, bool, NodeHash> closedSet;
+        FrameArena& arena = frameArena();
+        FrameVector<Node> openSet{ FrameAllocator<Node>(arena) };
+        FrameUnorderedMap<Node, bool, NodeHash> closedSet{ 0, NodeHash(), std::equal_to<Node>(), FrameAllocator<Node>(arena) };
 
         startNode.h_cost = calculateHeuristic(startNode, goalNode);
         openSet.push_back(startNode);
@@ -268,9 +395,11 @@ public:
                 [](const Node& a, const Node& b) { return a.f_cost() < b.f_cost(); });
 
             Node currentNode = *current;
+            COUNTER_ADD("A* nodes expanded", 1);
 
             if (currentNode.x == goalNode.x && currentNode.y == goalNode.y) {
-                return reconstructPath(currentNode);
+                reconstructPath(currentNode, path);
+                return;
             }
 
             openSet.erase(current);
@@ -298,7 +427,7 @@ public:
                     if (existingNode == openSet.end() || newGCost < existingNode->g_cost) {
                         neighbor.g_cost = newGCost;
                         neighbor.h_cost = calculateHeuristic(neighbor, goalNode);
-                        neighbor.parent = new Node(currentNode);
+                        neighbor.parent = arena.create<Node>(currentNode);
 
                         if (existingNode == openSet.end()) {
                             openSet.push_back(neighbor);
@@ -312,7 +441,6 @@ public:
         }
 
         // No path found
-        return std::vector<sf::Vector2f>();
     }
 
 private:
@@ -321,8 +449,7 @@ private:
         return std::abs(a.x - b.x) + std::abs(a.y - b.y);
     }
 
-    static std::vector<sf::Vector2f> reconstructPath(const Node& endNode) {
-        std::vector<sf::Vector2f> path;
+    static void reconstructPath(const Node& endNode, std::vector<sf::Vector2f>& path) {
         const Node* current = &endNode;
 
         while (current != nullptr) {
@@ -334,7 +461,6 @@ private:
         }
 
         std::reverse(path.begin(), path.end());
-        return path;
     }
 };
 
@@ -343,15 +469,17 @@ class Player
 public:
     // Dash-related variables 
     bool isDashing = false;
-    sf::Clock dashClock;
-    sf::Clock dashDurationClock;
+    Countdown dashCooldownTimer{ simTimers };
+    Countdown dashTimer{ simTimers };
 
-    sf::Clock damageCooldownClock;
+    Countdown damageCooldownTimer{ simTimers };
     const float damageCooldown = 2.15f; // Half a second between hits
 
     // Attack-related variables
-    sf::Clock attackCooldownClock;
+    Countdown attackCooldownTimer{ simTimers };
+    Countdown attackTimer{ simTimers }; // Clears isAttacking when the swing window ends
     const float attackCooldown = 0.5f; // Half second between attacks
+    const float attackWindow = 0.2f;
     bool isAttacking = false;
     const int attackDamage = 1;
 
@@ -362,24 +490,21 @@ public:
 
     sf::Vector2i size = sf::Vector2i(48, 64); // Size of the player sprite
 
-    sf::Clock healingClock; // Tracks time for healing
+    Countdown healingTimer{ simTimers }; // Tracks time for healing
     const float healingCooldown = 5.0f; // 15 seconds cooldown for healing
 
-    // Animation textures
-    sf::Texture playerTexture;
-    sf::Texture idleTexture;
+    // Animation state, stepped by the global animation system
+    AnimatorHandle animator{ animations };
 
     sf::RectangleShape hitBox;
     int health = 10; // Player starts with 5 health points
     int score = 0;   // Player's score
 
     // Add death-related variables
-    sf::Texture deathTexture;
     bool isDead = false;
     bool deathAnimationComplete = false;
-    sf::Clock deathClock;
+    Countdown deathTimer{ simTimers };
     const float deathDuration = 1.0f; // Duration of death animation in seconds
-    int deathFrame = 0; // Frame counter for death animation
 
     Player()
     {
@@ -389,84 +514,29 @@ public:
     }
     void renderPlayer()
     {
-        if (playerTexture.loadFromFile("Assets/Player/Textures/spritesheet2.png"))
-        {
-            std::cout << "The player has been loaded" << std::endl;
-
-            playerSprite.setTexture(playerTexture);
-
-            int xIndex = 0;
-            int yIndex = 0;
-            playerSprite.setTextureRect(sf::IntRect({ xIndex * size.x, yIndex * size.y }, { size.x, size.y }));
-            playerSprite.scale({ 2.0f, 2.0f });
-            playerSprite.setPosition({ 100, 100 });
-
-            // Load idle texture
-            if (idleTexture.loadFromFile("Assets/Player/Textures/Idle/idle_down.png"))
-            {
-                std::cout << "Idle texture loaded successfully" << std::endl;
-            }
-            else
-            {
-                std::cout << "Failed to load idle texture!" << std::endl;
-            }
-
-            // Load death texture
-            if (deathTexture.loadFromFile("Assets/Player/Textures/Death/death_normal_down.png"))
-            {
-                std::cout << "Death texture loaded successfully" << std::endl;
-            }
-            else
-            {
-                std::cout << "Failed to load death texture!" << std::endl;
-            }
-        }
-        else
-        {
-            std::cout << "Player not loaded!!" << std::endl;
-        }
+        // Sprite sheets are packed up front into the sprite atlas
+        const AtlasRegion& sheet = textures.get(TextureId::PlayerSheet);
+        playerSprite.setTexture(*sheet.page);
+        playerSprite.setTextureRect(sf::IntRect(sheet.rect.position, { size.x, size.y }));
+        playerSprite.scale({ 2.0f, 2.0f });
+        playerSprite.setPosition({ 100, 100 });
+
+        animator.play(PLAYER_IDLE_CLIP, true);
+        animator.apply(playerSprite);
+        LOG_INFO(LogCategory::Player, "The player has been loaded");
     }
-    sf::Clock animationClock;
-    const float animationDelay = 0.1f; // seconds
-    int currentFrame = 0;
-    void playerHealth(sf::RenderWindow& window)
+    void playerMovement(const InputFrame& input)
     {
-        sf::Texture healthTexture;
-        if (!healthTexture.loadFromFile("Assets/UI/HeartIcons_32x32.png"))
-        {
-            std::cout << "Failed to load heart icon texture!" << std::endl;
-            return;
-        }
+        PROFILE_ZONE("playerMovement");
 
-        // Draw hearts based on the player's current health
-        for (int i = 0; i < health; ++i)
-        {
-            sf::Sprite healthSprite(healthTexture);
-            healthSprite.setTextureRect(sf::IntRect({ 0, 0 }, { 32, 32 })); // Assuming the heart icon is at (0,0) in the texture
-            healthSprite.setScale({ 0.75f, 0.75f });
-            healthSprite.setPosition({ 10.f + i * 30.f, 10.f });
-            window.draw(healthSprite);
-        }
-    }
-    void playerMovement()
-    {
         if (isDead) {
-            // Handle death animation
+            // Handle death animation; deathTimer flags completion
             if (!deathAnimationComplete) {
                 updateDeathAnimation();
-                if (deathClock.getElapsedTime().asSeconds() > deathDuration) {
-                    deathAnimationComplete = true;
-                }
             }
             return; // Don't process movement if dead
         }
 
-        static int frame = 0;
-        static sf::Clock animationClock;
-        static sf::Clock dashClock;
-        static sf::Clock dashDurationClock;
-        static bool isDashing = false;
-
         const float normalSpeed = 2.0f;
         const float dashSpeed = 6.5f;
         const float dashCooldown = 1.0f;
@@ -474,82 +544,64 @@ public:
 
         float speed = normalSpeed;
         sf::Vector2f move(0.f, 0.f);
-        int yIndex = 0;
+        Facing facing = Facing::Down;
         bool isMoving = false;
+        bool attackStarted = false;
 
         // Attack input check using left mouse button
-        if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left) && attackCooldownClock.getElapsedTime().asSeconds() > attackCooldown) {
+        if (input.isHeld(InputFrame::Attack) && attackCooldownTimer.hasExpired()) {
             isAttacking = true;
-            attackCooldownClock.restart();
-            // Reset frame when starting a new attack
-            frame = 0;
+            attackCooldownTimer.start(attackCooldown);
+            // Reset attack state after a short duration
+            attackTimer.start(attackWindow, [this] { isAttacking = false; });
+            // Restart the attack clip for each new attack
+            attackStarted = true;
         }
 
         // Movement direction
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) {
+        if (input.isHeld(InputFrame::Right)) {
             move.x += 1;
-            yIndex = isDashing ? 11 : (isAttacking ? 8 : 5); // Right dash/attack/walk
+            facing = Facing::Right;
             isMoving = true;
         }
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) {
+        if (input.isHeld(InputFrame::Left)) {
             move.x -= 1;
-            yIndex = isDashing ? 7 : (isAttacking ? 4 : 1); // Left dash/attack/walk
+            facing = Facing::Left;
             isMoving = true;
         }
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S))
+        if (input.isHeld(InputFrame::Down))
         {
             move.y += 1;
-            yIndex = isDashing ? 6 : (isAttacking ? 2 : 0); // Down dash/attack/walk
+            facing = Facing::Down;
             isMoving = true;
         }
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W))
+        if (input.isHeld(InputFrame::Up))
         {
             move.y -= 1;
-            yIndex = isDashing ? 9 : (isAttacking ? 10 : 3); // Up dash/attack/walk
+            facing = Facing::Up;
             isMoving = true;
         }
 
-        // Reset attack state after a short duration
-        if (isAttacking && attackCooldownClock.getElapsedTime().asSeconds() > 0.2f) {
-            isAttacking = false;
-        }
-
         // Normalize diagonal movement
         if (move.x != 0 && move.y != 0)
             move /= std::sqrt(2.f);
 
         // Dash logic
-        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) && !isDashing && dashClock.getElapsedTime().asSeconds() > dashCooldown) {
+        if (input.isHeld(InputFrame::Dash) && !isDashing && dashCooldownTimer.hasExpired()) {
             isDashing = true;
-            dashDurationClock.restart();
-            dashClock.restart();
+            dashTimer.start(dashDuration, [this] { isDashing = false; });
+            dashCooldownTimer.start(dashCooldown);
         }
 
         if (isDashing)
         {
             speed = dashSpeed;
-            if (dashDurationClock.getElapsedTime().asSeconds() > dashDuration)
-            {
-                isDashing = false;
-            }
         }
 
         // Handle animation based on state
         if (isAttacking)
         {
-            // Attack animation has fewer frames (typically 4-6)
-            float frameDelay = 0.1f;
-            int totalFrames = 6; // Adjust based on your attack animation frames
-
-            if (animationClock.getElapsedTime().asSeconds() > frameDelay)
-            {
-                frame = (frame + 1) % totalFrames;
-                animationClock.restart();
-            }
-
-
-            // Set sprite from the right row (yIndex) and frame
-            playerSprite.setTextureRect(sf::IntRect({ frame * 48, yIndex * 64 }, { 48, 64 }));
+            animator.play(playerClip(PlayerAction::Attack, facing), attackStarted);
         }
         else if (isMoving)
         {
@@ -588,36 +640,15 @@ public:
                 playerSprite.move(move * speed);
             }
 
-            float frameDelay = isDashing ? 0.08f : 0.1f;
-            int totalFrames = 8; // Walking animation has 8 frames
-
-            if (animationClock.getElapsedTime().asSeconds() > frameDelay)
-            {
-                frame = (frame + 1) % totalFrames;
-                animationClock.restart();
-            }
-
-            // Use the main player texture for walking animation
-            playerSprite.setTexture(playerTexture);
-            // Set sprite from the right row (yIndex) and frame
-            playerSprite.setTextureRect(sf::IntRect({ frame * 48, yIndex * 64 }, { 48, 64 }));
+            animator.play(playerClip(isDashing ? PlayerAction::Dash : PlayerAction::Walk, facing));
         }
         else
         {
-            // Idle animation 
-            float frameDelay = 0.2f;
-            int totalFrames = 4; // Idle animation has 4 frames
-
-            if (animationClock.getElapsedTime().asSeconds() > frameDelay)
-            {
-                frame = (frame + 1) % totalFrames;
-                animationClock.restart();
-            }
-
-            // Use the idle texture for idle animation
-            playerSprite.setTexture(idleTexture);
-            playerSprite.setTextureRect(sf::IntRect({ frame * 48, 0 }, { 48, 64 }));
+            animator.play(PLAYER_IDLE_CLIP);
         }
+
+        // Only rebinds the texture or rect when the clip or frame changed
+        animator.apply(playerSprite);
     }
 
     void takeDamage(int damage)
@@ -627,16 +658,15 @@ public:
         health -= damage;
         if (health < 0)
             health = 0; // Ensure health doesn't go below 0
-        std::cout << "Player Health: " << health << std::endl;
+        LOG_DEBUG(LogCategory::Combat, "Player Health: {}", health);
 
         if (health <= 0) {
             isDead = true;
-            deathClock.restart();
-            deathFrame = 0; // Reset frame for death animation
-            std::cout << "Player has died!" << std::endl;
+            deathTimer.start(deathDuration, [this] { deathAnimationComplete = true; });
+            LOG_INFO(LogCategory::Combat, "Player has died!");
         }
 
-        healingClock.restart(); // Reset healing clock on damage
+        healingTimer.start(healingCooldown); // Reset healing timer on damage
     }
 
     // friend function
@@ -645,19 +675,9 @@ public:
 
     void updateDeathAnimation() {
         if (!deathAnimationComplete) {
-            playerSprite.setTexture(deathTexture);
-            // Assuming death animation has 6 frames
-            int totalFrames = 6;
-            float frameDelay = 0.1f;
-
-            if (animationClock.getElapsedTime().asSeconds() > frameDelay) {
-                if (deathFrame < totalFrames - 1) {
-                    deathFrame++;
-                }
-                animationClock.restart();
-            }
-
-            playerSprite.setTextureRect(sf::IntRect({ deathFrame * size.x, 0 }, { size.x, size.y }));
+            // The death clip plays once and holds its last frame
+            animator.play(PLAYER_DEATH_CLIP);
+            animator.apply(playerSprite);
         }
     }
 }player;
@@ -665,12 +685,27 @@ public:
 // Declaration only
 bool intersects(const sf::FloatRect& a, const sf::FloatRect& b, const Enemy& enemy, const Player& player);
 
+// What sets the enemy kinds apart besides their clips
+struct EnemyStats {
+    const char* name;
+    int health;
+    int attackDamage;
+    int score;                  // For the kill
+    float hitBoxScale;          // Hit box size as a fraction of the scaled frame
+    sf::Vector2f hitBoxOffset;  // From the sprite's top left
+};
+
+const EnemyStats ENEMY_STATS[static_cast<size_t>(EnemyKind::Count)] = {
+    { "Slime", 5, 1, 10, 0.3f, { 40.f, 40.f } },
+    { "Goblin", 5, 2, 20, 0.3f, { 40.f, 40.f } },
+    { "Skeleton", 2, 1, 5, 0.5f, { 20.f, 26.f } },  // Horde fodder: two hits
+};
+
 
 class Enemy
 {
     std::optional<sf::Sprite> enemySprite;
-    sf::Texture idleTexture, walkTexture, attackTexture, hurtTexture, deathTexture;
-    bool isGoblin = false;  // Flag to identify if this enemy is a goblin
+    EnemyKind kind = EnemyKind::Slime; // Selects the clip table row and stats
     int attackDamage = 1;   // Default damage
 
     enum class State { Idle, Walk, Attack, Hurt, Dead };
@@ -678,12 +713,10 @@ class Enemy
 
     // Add stun-related variables
     bool isStunned = false;
-    sf::Clock stunClock;
+    Countdown stunTimer{ simTimers };
     const float stunDuration = 1.0f; // .5 second stun duration
 
-    int frame = 0;
-    sf::Clock animationClock;
-    float frameDelay = 0.1f;
+    AnimatorHandle animator{ animations };
 
     //  movement variables
     float speed = 1.25f;
@@ -693,29 +726,29 @@ class Enemy
     const float smoothingFactor = 0.15f;
     sf::Vector2f currentVelocity = sf::Vector2f(0.f, 0.f);
 
-    sf::Clock damageCooldownClock;
+    Countdown damageCooldownTimer{ simTimers };
     const float damageCooldown = 0.5f; // Time between taking damage
 
-    // Add a clock for hurt animation duration
-    sf::Clock hurtClock;
+    // Timer for hurt animation duration
+    Countdown hurtTimer{ simTimers };
     const float hurtDuration = 0.3f; // Duration of hurt animation in seconds
 
-    // Add a clock for death animation duration
-    sf::Clock deathClock;
+    // Timer for death animation duration
+    Countdown deathTimer{ simTimers };
     const float deathDuration = 1.0f; // Duration of death animation in seconds
     bool deathAnimationComplete = false;
 
     // New variables for pathfinding
     std::vector<sf::Vector2f> currentPath;
     size_t currentPathIndex = 0;
-    sf::Clock pathUpdateClock;
+    Countdown pathUpdateTimer{ simTimers };
 
     // Debug visualization
     std::vector<sf::CircleShape> pathVisualizers;
     bool showDebugPath = true;  // Set to true to see the path
 
     // Add stuck detection variables
-    sf::Clock stuckTimer;
+    uint64_t lastMoveTick = 0; // Simulation tick of the last successful move
     sf::Vector2f lastPosition;
     const float stuckThreshold = 0.5f; // Time in seconds to consider enemy stuck
     bool isStuck = false;
@@ -724,7 +757,7 @@ class Enemy
     sf::Vector2f lastTargetPos;
     int consecutivePathChanges = 0;
     const int maxPathChanges = 3;
-    sf::Clock pathChangeTimer;
+    Countdown pathChangeTimer{ simTimers };
     const float pathStabilityDelay = 1.0f;  // Minimum time between major path changes
     const float minPathLength = 32.0f;  // Minimum distance to consider a new path
 
@@ -736,16 +769,14 @@ public:
     bool isAlive = true;
     sf::RectangleShape hitBox;
 
-    Enemy(bool isGoblinType = false) : isGoblin(isGoblinType)
+    explicit Enemy(EnemyKind enemyKind = EnemyKind::Slime) : kind(enemyKind)
     {
         hitBox.setFillColor(sf::Color::Transparent);
         hitBox.setOutlineColor(sf::Color::Red);
         hitBox.setOutlineThickness(1.0f);
-        
-        // Set higher damage for goblins
-        if (isGoblin) {
-            attackDamage = 2;  // Goblin deals 2 damage per hit
-        }
+
+        health = stats().health;
+        attackDamage = stats().attackDamage;
     }
 
     Enemy(const Enemy&) = delete;
@@ -753,6 +784,10 @@ public:
     Enemy(Enemy&&) = default;
     Enemy& operator=(Enemy&&) = default;
 
+    sf::Vector2f getPosition() const {
+        return enemySprite ? enemySprite->getPosition() : sf::Vector2f();
+    }
+
     void setPosition(float x, float y) {
         if (enemySprite) {
             enemySprite->setPosition(sf::Vector2f(x, y));
@@ -761,56 +796,30 @@ public:
 
     void renderEnemy()
     {
-        if (isGoblin) {
-            if (!idleTexture.loadFromFile("Assets/Enemy/Golbin/Textures/spr_goblin_idle.png") ||
-                !walkTexture.loadFromFile("Assets/Enemy/Golbin/Textures/spr_goblin_walk.png") ||
-                !attackTexture.loadFromFile("Assets/Enemy/Golbin/Textures/spr_goblin_attack.png") ||
-                !hurtTexture.loadFromFile("Assets/Enemy/Golbin/Textures/spr_goblin_hurt.png") ||
-                !deathTexture.loadFromFile("Assets/Enemy/Golbin/Textures/spr_goblin_death.png")) {
-                std::cout << "Failed to load goblin textures!" << std::endl;
-                return;
-            }
-
-            enemySprite.emplace(idleTexture);
-            enemySprite->setTextureRect(sf::IntRect({ 0, 0 }, { 64, 64 }));
-            enemySprite->setPosition({ 400, 100 });
-            enemySprite->scale({ 2.0f, 2.0f });
-
-            // Adjust the hitBox size for goblin
-            hitBox.setSize({ 64.f * enemySprite->getScale().x * 0.3f,
-                            64.f * enemySprite->getScale().y * 0.3f });
-        } else {
-            // Original slime enemy code
-            if (!idleTexture.loadFromFile("Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_idle_shadowless.png") ||
-                !walkTexture.loadFromFile("Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_walk_shadowless.png") ||
-                !attackTexture.loadFromFile("Assets/Enemy/Slime/Blue Slime/Textures/shadowless/spr_Blue_slime_attack_shadowless.png") ||
-                !hurtTexture.loadFromFile("Assets/Enemy/Slime/Blue Slime/Textures/spr_Blue_slime_hurt.png") ||
-                !deathTexture.loadFromFile("Assets/Enemy/Slime/Blue Slime/Textures/spr_Blue_slime_death.png"))
-            {
-                std::cout << "Failed to load one or more slime textures!" << std::endl;
-                return;
-            }
-
-            enemySprite.emplace(idleTexture);
-            enemySprite->setTextureRect(sf::IntRect({ 0, 0 }, { 64, 64 }));
-            enemySprite->setPosition({ 400, 100 });
-            enemySprite->scale({ 2.0f, 2.0f });
-
-            // Adjust the hitBox size for slime
-            hitBox.setSize({ 64.f * enemySprite->getScale().x * 0.3f,
-                            64.f * enemySprite->getScale().y * 0.3f });
-        }
+        // Sprite sheets are shared through the texture library; only the sprite is per enemy
+        const AnimationClip& idleClip = clipFor(State::Idle);
+        enemySprite.emplace(*textures.get(idleClip.texture).page);
+        enemySprite->setTextureRect(sf::IntRect({ 0, 0 }, idleClip.frameSize));
+        enemySprite->setPosition({ 400, 100 });
+        enemySprite->scale({ 2.0f, 2.0f });
+        animator.play(idleClip, true);
+
+        // Adjust the hitBox size to the sprite
+        hitBox.setSize(hitBoxSize());
     }
 
-    void draw(sf::RenderWindow& window)
+    // The sprite to draw this frame, or nullptr; the caller depth-sorts and queues it
+    const sf::Sprite* getVisibleSprite(const Camera& camera) const
     {
-        if (!enemySprite) return;
+        if (!enemySprite) return nullptr;
 
         // Don't draw if death animation is complete
-        if (currentState == State::Dead && deathAnimationComplete) return;
+        if (currentState == State::Dead && deathAnimationComplete) return nullptr;
+
+        // Off-screen enemies are culled
+        if (!camera.isVisible(enemySprite->getGlobalBounds())) return nullptr;
 
-        // Draw the sprite
-        window.draw(*enemySprite);
+        return &*enemySprite;
        
         // draw debug path if alive
         /*
@@ -830,6 +839,8 @@ public:
 
     // Add line of sight check method
     bool hasLineOfSight(sf::Vector2f start, sf::Vector2f end) {
+        COUNTER_ADD("LOS rays", 1);
+
         // Get the direction vector
         sf::Vector2f direction = end - start;
         float distance = std::sqrt(direction.x * direction.x + direction.y * direction.y);
@@ -854,13 +865,14 @@ public:
     }
 
     void enemyMovement(sf::Vector2f playerPos) {
+        PROFILE_ZONE("enemyMovement");
         if (!enemySprite) return;
 
         // Handle death state
         if (currentState == State::Dead) {
             if (!deathAnimationComplete) {
                 updateAnimation();
-                if (deathClock.getElapsedTime().asSeconds() > deathDuration) {
+                if (deathTimer.hasExpired()) {
                     deathAnimationComplete = true;
                     enemySprite.reset();
                     // Only switch back to background music when the enemy is completely dead
@@ -876,7 +888,7 @@ public:
         if (currentState == State::Hurt) {
             updateAnimation();
             // Return to previous state after hurt animation
-            if (hurtClock.getElapsedTime().asSeconds() > hurtDuration) {
+            if (hurtTimer.hasExpired()) {
                 currentState = State::Idle;
                 isStunned = false;  // End stun when hurt animation ends
             }
@@ -885,7 +897,7 @@ public:
 
         // Handle stun state
         if (isStunned) {
-            if (stunClock.getElapsedTime().asSeconds() >= stunDuration) {
+            if (stunTimer.hasExpired()) {
                 isStunned = false;
             }
             else {
@@ -944,11 +956,11 @@ public:
 
                     // Always try to find a path if we don't have one
                     if (currentPath.empty()) {
-                        currentPath = PathFinder::findPath(mapManager, slimePos, playerCenterPos);
+                        PathFinder::findPath(mapManager, slimePos, playerCenterPos, currentPath);
                         currentPathIndex = 0;
                     }
                     // Update path periodically or if we're stuck
-                    else if (pathUpdateClock.getElapsedTime().asSeconds() >= pathUpdateInterval) {
+                    else if (pathUpdateTimer.hasExpired()) {
                         // Check if we're making progress
                         float progressDistance = std::sqrt(
                             std::pow(currentPath[currentPathIndex].x - slimePos.x, 2) +
@@ -957,10 +969,10 @@ public:
 
                         // If we're not getting closer to the next point, try a new path
                         if (progressDistance > 32.0f) {
-                            currentPath = PathFinder::findPath(mapManager, slimePos, playerCenterPos);
+                            PathFinder::findPath(mapManager, slimePos, playerCenterPos, currentPath);
                             currentPathIndex = 0;
                         }
-                        pathUpdateClock.restart();
+                        pathUpdateTimer.start(pathUpdateInterval);
                     }
                 }
             }
@@ -990,7 +1002,7 @@ public:
                     // If we've reached the end of the path but still can see the player,
                     // try to find a new path to the player's current position
                     if (canSeePlayer && distance < detectionRange) {
-                        currentPath = PathFinder::findPath(mapManager, slimePos, playerCenterPos);
+                        PathFinder::findPath(mapManager, slimePos, playerCenterPos, currentPath);
                         currentPathIndex = 0;
                     }
                     else {
@@ -1063,7 +1075,7 @@ public:
 
                 // Try to find an alternative path
                 sf::Vector2f offset(32.f, 0.f);  // Try offset positions
-                std::vector<sf::Vector2f> alternativeTargets = {
+                const std::array<sf::Vector2f, 4> alternativeTargets = {
                     playerCenterPos + offset,
                     playerCenterPos - offset,
                     playerCenterPos + sf::Vector2f(0.f, 32.f),
@@ -1072,7 +1084,7 @@ public:
 
                 for (const auto& target : alternativeTargets) {
                     if (mapManager.isPositionPassable(target.x, target.y)) {
-                        currentPath = PathFinder::findPath(mapManager, slimePos, target);
+                        PathFinder::findPath(mapManager, slimePos, target, currentPath);
                         if (!currentPath.empty()) {
                             currentPathIndex = 0;
                             break;
@@ -1084,35 +1096,35 @@ public:
             if (canMove) {
                 enemySprite->setPosition(newPos);
                 lastPosition = newPos;  // Update last position
-                stuckTimer.restart();   // Reset stuck timer
+                lastMoveTick = simTimers.now();   // Reset stuck detection
             }
             else {
                 // Check if we're stuck
-                if (stuckTimer.getElapsedTime().asSeconds() > stuckThreshold) {
+                if (simTimers.now() - lastMoveTick > secondsToTicks(stuckThreshold)) {
                     // If stuck for too long, try to find a path to a random nearby position
                     sf::Vector2f randomOffset(
-                        (std::rand() % 64) - 32.f,
-                        (std::rand() % 64) - 32.f
+                        static_cast<float>(world.random.range(-32, 31)),
+                        static_cast<float>(world.random.range(-32, 31))
                     );
                     sf::Vector2f escapeTarget = slimePos + randomOffset;
 
                     if (mapManager.isPositionPassable(escapeTarget.x, escapeTarget.y)) {
-                        currentPath = PathFinder::findPath(mapManager, slimePos, escapeTarget);
+                        PathFinder::findPath(mapManager, slimePos, escapeTarget, currentPath);
                         currentPathIndex = 0;
                     }
 
-                    stuckTimer.restart();
+                    lastMoveTick = simTimers.now();
                 }
             }
 
             // Reduce speed when close to walls
             float wallProximityThreshold = 32.0f;
             bool nearWall = false;
-            std::vector<sf::Vector2f> checkPoints = {
-                {newPos.x - wallProximityThreshold, newPos.y},
-                {newPos.x + wallProximityThreshold, newPos.y},
-                {newPos.x, newPos.y - wallProximityThreshold},
-                {newPos.x, newPos.y + wallProximityThreshold}
+            const std::array<sf::Vector2f, 4> checkPoints = {
+                sf::Vector2f{newPos.x - wallProximityThreshold, newPos.y},
+                sf::Vector2f{newPos.x + wallProximityThreshold, newPos.y},
+                sf::Vector2f{newPos.x, newPos.y - wallProximityThreshold},
+                sf::Vector2f{newPos.x, newPos.y + wallProximityThreshold}
             };
 
             for (const auto& point : checkPoints) {
@@ -1136,7 +1148,7 @@ public:
 
     void takeDamage(int damage)
     {
-        if (!isAlive || damageCooldownClock.getElapsedTime().asSeconds() < damageCooldown)
+        if (!isAlive || damageCooldownTimer.isRunning())
             return;
 
         health -= damage;
@@ -1145,34 +1157,27 @@ public:
             isAlive = false;
             health = 0;
             currentState = State::Dead;
-            deathClock.restart();
-            frame = 0;  // Reset frame for death animation
+            deathTimer.start(deathDuration);
             currentPath.clear();
             currentVelocity = sf::Vector2f(0.f, 0.f);
             
             // Increase player score when enemy dies
-            if (isGoblin) {  // If it's a goblin
-                player.score += 20;  // Add 20 points for goblin kill
-                std::cout << "Goblin defeated! Score increased by 20. Total score: " << player.score << std::endl;
-            } else {  // If it's a slime
-                player.score += 10;  // Add 10 points for slime kill
-                std::cout << "Slime defeated! Score increased by 10. Total score: " << player.score << std::endl;
-            }
+            player.score += stats().score;
+            LOG_DEBUG(LogCategory::Combat, "{} defeated! Score increased by {}. Total score: {}", stats().name, stats().score, player.score);
             
-            std::cout << "Enemy defeated!" << std::endl;
+            LOG_DEBUG(LogCategory::Combat, "Enemy defeated!");
         }
         else {
             // Only apply stun and set hurt state if not already in hurt state
             if (currentState != State::Hurt) {
                 isStunned = true;
-                stunClock.restart();
+                stunTimer.start(stunDuration);
                 currentState = State::Hurt;
-                hurtClock.restart();
-                frame = 0;  // Reset frame for hurt animation
-                std::cout << "Enemy Health: " << health << std::endl;
+                hurtTimer.start(hurtDuration);
+                LOG_DEBUG(LogCategory::Combat, "Enemy Health: {}", health);
             }
         }
-        damageCooldownClock.restart();
+        damageCooldownTimer.start(damageCooldown);
     }
 
     bool isDeathAnimationComplete() const {
@@ -1182,147 +1187,96 @@ public:
     friend void updateHitBox(Player& player, Enemy& enemy);
 
 private:
-    void updateAnimation() {
-        if (!enemySprite) return;
+    const AnimationClip& clipFor(State state) const {
+        return ENEMY_CLIPS[static_cast<size_t>(kind)][static_cast<size_t>(state)];
+    }
 
-        int totalFrames = 0;
-        float currentFrameDelay = frameDelay;  // Default frame delay
-
-        if (isGoblin) {
-            // Goblin animation logic
-            switch (currentState) {
-                case State::Dead:
-                    enemySprite->setTexture(deathTexture);
-                    totalFrames = 4;  // Goblin death animation has 4 frames
-                    if (frame >= totalFrames - 1) {
-                        frame = totalFrames - 1;  // Stay on last frame
-                        return;
-                    }
-                    break;
-                case State::Hurt:
-                    enemySprite->setTexture(hurtTexture);
-                    totalFrames = 4;  // Goblin hurt animation has 4 frames
-                    break;
-                case State::Attack:
-                    enemySprite->setTexture(attackTexture);
-                    totalFrames = 14;  // Goblin attack animation has 14 frames
-                    currentFrameDelay = frameDelay * 0.5f;  // Make attack animation twice as fast
-                    // Reset frame when starting attack
-                    if (frame >= totalFrames) {
-                        frame = 0;
-                    }
-                    break;
-                case State::Walk:
-                    enemySprite->setTexture(walkTexture);
-                    totalFrames = 4;  // Goblin walk animation has 4 frames
-                    break;
-                default:
-                    enemySprite->setTexture(idleTexture);
-                    totalFrames = 4;  // Goblin idle animation has 4 frames
-                    break;
-            }
+    const EnemyStats& stats() const {
+        return ENEMY_STATS[static_cast<size_t>(kind)];
+    }
 
-            if (animationClock.getElapsedTime().asSeconds() > currentFrameDelay) {
-                if (currentState == State::Dead) {
-                    if (frame < totalFrames - 1) {
-                        frame++;
-                    }
-                } else if (currentState == State::Attack) {
-                    // For attack animation, play once and return to idle
-                    if (frame < totalFrames - 1) {
-                        frame++;
-                    } else {
-                        currentState = State::Idle;
-                        frame = 0;
-                    }
-                } else {
-                    frame = (frame + 1) % totalFrames;
-                }
-                animationClock.restart();
-            }
+    sf::Vector2f hitBoxSize() const {
+        sf::Vector2f frame(clipFor(State::Idle).frameSize);
+        return { frame.x * enemySprite->getScale().x * stats().hitBoxScale,
+                 frame.y * enemySprite->getScale().y * stats().hitBoxScale };
+    }
 
-            enemySprite->setTextureRect(sf::IntRect({ frame * 64, 0 }, { 64, 64 }));
-        } else {
-            // Original slime animation logic
-            switch (currentState) {
-                case State::Dead:
-                    enemySprite->setTexture(deathTexture);
-                    totalFrames = 6;
-                    if (frame >= totalFrames - 1) {
-                        frame = totalFrames - 1;
-                        return;
-                    }
-                    break;
-                case State::Idle:
-                    enemySprite->setTexture(idleTexture);
-                    totalFrames = 6;
-                    break;
-                case State::Walk:
-                    enemySprite->setTexture(walkTexture);
-                    totalFrames = 6;
-                    break;
-                case State::Attack:
-                    enemySprite->setTexture(attackTexture);
-                    totalFrames = 15;
-                    break;
-                case State::Hurt:
-                    enemySprite->setTexture(hurtTexture);
-                    totalFrames = 4;
-                    break;
-            }
+    void updateAnimation() {
+        if (!enemySprite) return;
 
-            if (animationClock.getElapsedTime().asSeconds() > frameDelay) {
-                if (currentState == State::Dead) {
-                    if (frame < totalFrames - 1) {
-                        frame++;
-                    }
-                } else {
-                    frame = (frame + 1) % totalFrames;
-                }
-                animationClock.restart();
-            }
+        // Entering a new state starts its clip from the first frame
+        animator.play(clipFor(currentState));
 
-            enemySprite->setTextureRect(sf::IntRect({ frame * 64, 0 }, { 64, 64 }));
+        // One-shot attacks (goblin) hand control back to idle once played out
+        if (currentState == State::Attack && animator.isFinished()) {
+            currentState = State::Idle;
+            animator.play(clipFor(currentState));
         }
+
+        animator.apply(*enemySprite);
     }
 }enemy;
 
-// List for enemies
-std::list<Enemy> enemies;
-const int MAX_ENEMIES = 5; // Maximum number of enemies to spawn
+World world;
 
-// Update spawnEnemy function to spawn specific enemy types based on level
-void spawnEnemy() {
-    if (enemies.size() >= MAX_ENEMIES) return;
+// Everything drawn through the sprite batch comes from one atlas: the prebuilt one from
+// AtlasPacker if it is up to date, otherwise packed here at startup. Decoding runs on a
+// worker (prepareSpriteAtlas), the upload on the GL thread (uploadSpriteAtlas).
+bool prepareSpriteAtlas(unsigned int pageSize) {
+    addSpriteAtlasSources(spriteAtlas);
 
-    // Determine enemy type based on current level
-    bool isGoblin = (mapManager.getCurrentMapNumber() == 2);
-    Enemy newEnemy(isGoblin);
-    newEnemy.renderEnemy();
+    if (!spriteAtlas.prepare(SPRITE_ATLAS_TABLE, pageSize)) {
+        std::cerr << "Some images could not be packed into the sprite atlas!" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    // Keep trying to find a valid spawn position
-    float randomX, randomY;
-    bool validPosition = false;
-    int maxAttempts = 100;
-    int attempts = 0;
+bool uploadSpriteAtlas() {
+    if (!spriteAtlas.upload()) return false;
+    // Every sprite, tile and icon lives in the atlas pages
+    COUNTER_SET("textures resident", spriteAtlas.getPageCount());
 
-    while (!validPosition && attempts < maxAttempts) {
-        randomX = static_cast<float>(rand() % (MAP_WIDTH_PIXELS - 100));
-        randomY = static_cast<float>(rand() % (MAP_HEIGHT_PIXELS - 100));
+    // Resolve animation sheets to their atlas regions
+    if (!textures.bind(spriteAtlas)) {
+        std::cerr << "Failed to load one or more sprite sheets!" << std::endl;
+        return false;
+    }
+    return true;
+}
 
-        if (mapManager.isPositionPassable(randomX + 32.f, randomY + 32.f)) {
-            validPosition = true;
-        }
-        attempts++;
+void fillEnemyPool(const WavePlan& plan) {
+    for (auto& pool : world.enemyPool) pool.clear();
+    for (const Wave& wave : plan.waves) {
+        std::list<Enemy>& pool = world.enemyPool[static_cast<size_t>(wave.kind)];
+        for (int i = 0; i < wave.count; ++i) pool.emplace_back(wave.kind);
     }
+    COUNTER_SET("enemies pooled", plan.getTotalCount());
+}
 
-    if (validPosition) {
-        newEnemy.setPosition(randomX, randomY);
-        enemies.emplace_back(std::move(newEnemy));
-        std::cout << (isGoblin ? "Goblin" : "Slime") << " spawned at (" << randomX << ", " << randomY << ")! Total enemies: " << enemies.size() << std::endl;
+// Lets the next pooled enemy of a kind in: the opening wave on its pre-rolled tiles, later
+// ones on a random table tile away from where the player is now
+void spawnEnemy(EnemyKind kind) {
+    std::list<Enemy>& pool = world.enemyPool[static_cast<size_t>(kind)];
+    if (pool.empty()) return;
+
+    sf::Vector2f position;
+    if (world.openingSpawnsUsed < world.openingSpawnPoints.size()) {
+        position = world.openingSpawnPoints[world.openingSpawnsUsed++];
+    } else if (!world.spawnTable.isEmpty()) {
+        sf::Vector2f playerCenter = playerSprite.getPosition() + playerSprite.getGlobalBounds().size / 2.f;
+        position = world.spawnTable.pickAwayFrom(world.random, playerCenter, SpawnRules().minPlayerDistance);
     } else {
-        std::cout << "Failed to find valid spawn position for enemy after " << maxAttempts << " attempts." << std::endl;
+        return;
     }
+
+    std::list<Enemy>& enemies = world.enemies;
+    enemies.splice(enemies.end(), pool, pool.begin());
+    Enemy& enemy = enemies.back();
+    enemy.renderEnemy();
+    enemy.setPosition(position.x, position.y);
+    COUNTER_ADD("enemies spawned", 1);
+    LOG_DEBUG(LogCategory::Spawn, "{} spawned at ({}, {})! Total enemies: {}", ENEMY_STATS[static_cast<size_t>(kind)].name, position.x, position.y, enemies.size());
 }
 
 // Define the intersects function after the Enemy class is fully defined
@@ -1348,6 +1302,8 @@ bool intersects(const sf::FloatRect& a, const sf::FloatRect& b, const Enemy& ene
 
 void updateHitBox(Player& player, Enemy& enemy)
 {
+    PROFILE_ZONE("updateHitBox");
+
     // Update Player HitBox - always update regardless of enemy state
     player.hitBox.setSize({ static_cast<float>(player.size.x) * playerSprite.getScale().x * 0.4f,
                         static_cast<float>(player.size.y) * playerSprite.getScale().y * 0.4f });
@@ -1364,9 +1320,8 @@ void updateHitBox(Player& player, Enemy& enemy)
     // Update Enemy HitBox
     if (enemy.enemySprite)
     {
-        enemy.hitBox.setSize({ 64.f * enemy.enemySprite->getScale().x * 0.3f,
-                            64.f * enemy.enemySprite->getScale().y * 0.3f });
-        enemy.hitBox.setPosition(sf::Vector2f(enemy.enemySprite->getPosition().x + 40.f, enemy.enemySprite->getPosition().y + 40.f));
+        enemy.hitBox.setSize(enemy.hitBoxSize());
+        enemy.hitBox.setPosition(enemy.enemySprite->getPosition() + enemy.stats().hitBoxOffset);
     }
 
     // Check for collision and apply damage
@@ -1374,10 +1329,10 @@ void updateHitBox(Player& player, Enemy& enemy)
     {
         // Enemy damages player
         if (enemy.currentState == Enemy::State::Attack &&
-            player.damageCooldownClock.getElapsedTime().asSeconds() > player.damageCooldown)
+            player.damageCooldownTimer.hasExpired())
         {
             player.takeDamage(enemy.attackDamage);  // Use enemy's attackDamage
-            player.damageCooldownClock.restart();
+            player.damageCooldownTimer.start(player.damageCooldown);
         }
 
         // Player damages enemy
@@ -1390,17 +1345,17 @@ void updateHitBox(Player& player, Enemy& enemy)
 
 void updateHealing(Player& player)
 {
-    if (player.health < 10 && player.healingClock.getElapsedTime().asSeconds() > player.healingCooldown)
+    if (player.health < 10 && player.healingTimer.hasExpired())
     {
         player.health += 1; // Heal 1 health point
-        player.healingClock.restart(); // Restart the healing clock
-        std::cout << "Player healed! Current Health: " << player.health << std::endl;
+        player.healingTimer.start(player.healingCooldown); // Restart the healing timer
+        LOG_DEBUG(LogCategory::Player, "Player healed! Current Health: {}", player.health);
     }
 }
 
 // Add function to check if all enemies are dead
 bool areAllEnemiesDead() {
-    for (const auto& enemy : enemies) {
+    for (const auto& enemy : world.enemies) {
         if (enemy.isAlive) {
             return false;
         }
@@ -1409,52 +1364,197 @@ bool areAllEnemiesDead() {
 }
 
 
-std::string forestTilesheet = "Assets/Map/Fantasy/forest_/forest_1.png";
-std::string tundraTilesheet = "Assets/Map/Fantasy/tundra_/tundra_.png";
+// Atlas region of the current map's tilesheet
+AtlasRegion mapTilesheet;
+
+// Where every level's enemies may spawn
+SpawnRules levelSpawnRules() {
+    SpawnRules rules;
+    rules.playerStart = PLAYER_START_POSITION + playerSprite.getGlobalBounds().size / 2.f;
+    rules.probeOffset = sf::Vector2f(32.f, 32.f);
+    return rules;
+}
+
+// Swap a prepared level in: map, tilesheet, player start position and enemies.
+// Nothing is loaded here; the level was built by levelLoader.
+bool startLevel(PreparedLevel level) {
+    if (!level.loaded) return false;
+
+    if (level.streamed) {
+        if (!mapManager.loadMap(level.mapNumber)) return false;
+    } else {
+        mapManager.adoptMap(level.mapNumber, level.filename, std::move(level.map), std::move(level.nav));
+    }
 
-// Declare mapTilesheet as a global variable
-sf::Texture mapTilesheet;
+    mapTilesheet = spriteAtlas.find(level.tilesheetPath);
+    if (!mapTilesheet.isValid()) {
+        LOG_ERROR(LogCategory::Map, "Failed to load map tilesheet: {}", level.tilesheetPath);
+    }
 
-// Update loadNextMap to also switch tilesheet
+    // Reset player position to a safe starting position
+    playerSprite.setPosition(PLAYER_START_POSITION);
+    focusCameraOnPlayer();
+
+    // A streamed map's tiles are only known once its chunks are in: list the loaded part
+    world.spawnTable = std::move(level.spawnTable);
+    if (level.streamed) {
+        world.spawnTable.build(levelSpawnRules(), mapManager.getLoadedArea(), mapManager.getNavGrid(),
+            [](int x, int y) { return mapManager.isTilePassable(x, y); });
+    }
+    if (world.spawnTable.isEmpty()) {
+        LOG_WARNING(LogCategory::Spawn, "No spawn tiles on map {}, enemies will not spawn", level.mapNumber);
+    } else if (!world.spawnTable.isKeptAwayFromPlayer()) {
+        LOG_WARNING(LogCategory::Spawn, "Map {} is too small to keep enemies away from the player", level.mapNumber);
+    }
+
+    // Replace the enemies: the whole level is pooled now and let in by the waves, the
+    // opening wave on its pre-rolled tiles
+    world.enemies.clear();
+    fillEnemyPool(level.waves);
+    world.openingSpawnPoints = std::move(level.spawnPoints);
+    world.openingSpawnsUsed = 0;
+    LOG_INFO(LogCategory::Spawn, "Map {}: {} enemies in {} waves, at most {} at once", level.mapNumber,
+        level.waves.getTotalCount(), level.waves.waves.size(), level.waves.maxAlive);
+    world.waves.start(std::move(level.waves));
+    return true;
+}
+
+bool switchToMap(int mapNumber) {
+    return startLevel(levelLoader.take(mapNumber, levelSpawnRules(), world.random.next()));
+}
+
+// Load the level after the current one (prefetched while "LEVEL CLEARED" was shown)
 void loadNextMap() {
-    int currentMap = mapManager.getCurrentMapNumber();
-    int nextMap = currentMap + 1;
-    
-    // Save current player position
-    sf::Vector2f currentPlayerPos = playerSprite.getPosition();
-    
-    // Set correct tilesheet for the map
-    std::string newTilesheetPath = forestTilesheet;
-    if (nextMap == 2) {
-        newTilesheetPath = tundraTilesheet;
+    int nextMap = mapManager.getCurrentMapNumber() + 1;
+    if (switchToMap(nextMap)) {
+        LOG_INFO(LogCategory::Map, "Successfully loaded map {} after clearing all enemies!", nextMap);
+    } else {
+        LOG_ERROR(LogCategory::Map, "Failed to load next map {}", nextMap);
     }
-    if (!mapTilesheet.loadFromFile(newTilesheetPath)) {
-        std::cerr << "Failed to load map tilesheet: " << newTilesheetPath << std::endl;
+}
+
+void World::step(const InputFrame& frameInput) {
+    lastInput = frameInput;
+    const InputFrame& input = lastInput;
+
+    // Confirm moves on from the title and transition screens
+    if (input.confirm) {
+        switch (screen) {
+        case Screen::Title:
+            screen = Screen::Playing;
+            break;
+        case Screen::LevelCleared:
+            screen = Screen::Playing;
+            loadNextMap();
+            break;
+        case Screen::GameOver:
+        case Screen::ToBeContinued:
+            quitRequested = true;
+            break;
+        case Screen::Playing:
+            break;
+        }
     }
-    
-    // Try to load the next map
-    if (mapManager.loadMap(nextMap)) {
-        // Reset player position to a safe starting position
-        playerSprite.setPosition({100, 100});
-        
-        // Clear existing enemies
-        enemies.clear();
-        
-        // Spawn new enemies for the new map
-        for (int i = 0; i < 5; ++i) {
-            spawnEnemy();
+
+    // Number keys jump straight to a map
+    if (input.mapKey != 0) {
+        if (switchToMap(input.mapKey)) {
+            LOG_INFO(LogCategory::Map, "Successfully switched to map {}", input.mapKey);
+        } else {
+            LOG_ERROR(LogCategory::Map, "Failed to load map {}", input.mapKey);
         }
-        
-        std::cout << "Successfully loaded map " << nextMap << " after clearing all enemies!" << std::endl;
+    }
+
+    if (screen != Screen::Playing || quitRequested) return;
+    ++tick;
+
+    // Advance the simulation clock; expired entity timers fire here
+    simTimers.advance();
+    animations.update();
+
+    if (resampleHeld) {
+        lastInput.held = resampleHeld();
+    }
+    player.playerMovement(input);
+
+    // Remove dead enemies that have finished their death animation  
+    enemies.remove_if([](Enemy& e) { return !e.isAlive && e.isDeathAnimationComplete(); });  
+
+    // Let the next enemies of the level's waves in
+    waves.update(static_cast<int>(enemies.size()), frameLoad, [](EnemyKind kind) { spawnEnemy(kind); });
+
+    // Check if all enemies are dead and load next map if so
+    if (areAllEnemiesDead() && enemies.empty() && waves.isFinished()) {
+        if (mapManager.getCurrentMapNumber() == 1) {
+            screen = Screen::LevelCleared;
+
+            // Build the next level while the player looks at the transition screen
+            levelLoader.prefetch(mapManager.getCurrentMapNumber() + 1, levelSpawnRules(), random.next());
+        } else if (mapManager.getCurrentMapNumber() == 2) {
+            screen = Screen::ToBeContinued;
+            LOG_INFO(LogCategory::Game, "Level 2 cleared! Showing To Be Continued screen...");
+        } else {
+            loadNextMap();
+        }
+    }
+
+    // Update and check all enemies  
+    for (auto& enemy : enemies) {  
+        enemy.enemyMovement(playerSprite.getPosition());  
+        updateHitBox(player, enemy);  
+    }  
+
+    COUNTER_SET("enemies active", enemies.size());
+
+    // Heal the player if applicable  
+    updateHealing(player);  
+
+    // Check if the player is dead  
+    if (player.isDead && player.deathAnimationComplete) {  
+        screen = Screen::GameOver;
+    }  
+
+    // The camera decides which chunks of a streamed map are loaded, so it moves with the simulation
+    if (waitForStreaming) {
+        focusCameraOnPlayer();
     } else {
-        // If map loading failed, restore player position
-        playerSprite.setPosition(currentPlayerPos);
-        std::cerr << "Failed to load next map " << nextMap << std::endl;
+        sf::FloatRect playerBounds = playerSprite.getGlobalBounds();
+        camera.follow(playerBounds.position + playerBounds.size / 2.f, mapManager.getMapPixelSize());
+        mapManager.update(camera.getVisibleArea());
+    }
+}
+
+uint64_t World::checksum() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+    auto mixValue = [&mix](const auto& value) { mix(&value, sizeof(value)); };
+
+    mixValue(tick);
+    mixValue(screen);
+    mixValue(mapManager.getCurrentMapNumber());
+    sf::Vector2f playerPosition = playerSprite.getPosition();
+    mixValue(playerPosition.x);
+    mixValue(playerPosition.y);
+    mixValue(player.health);
+    mixValue(player.score);
+    for (const auto& enemy : enemies) {
+        sf::Vector2f position = enemy.getPosition();
+        mixValue(position.x);
+        mixValue(position.y);
+        mixValue(enemy.health);
+        mixValue(enemy.isAlive);
     }
+    return hash;
 }
 
 // Remove the drawMapInfo function and replace it with a simpler version
-void drawMapInfo(sf::RenderWindow& window, const MapManager& mapManager) {
+void drawMapInfo(const MapManager& mapManager) {
    
     static bool infoPrinted = false;
 
@@ -1463,39 +1563,64 @@ void drawMapInfo(sf::RenderWindow& window, const MapManager& mapManager) {
         std::filesystem::path path(filename);
         std::string mapName = path.filename().string();
 
-        std::cout << "Current map: " << mapManager.getCurrentMapNumber() << " (" << mapName << ")" << std::endl;
-        std::cout << "Press 1-9 to switch maps" << std::endl;
+        LOG_INFO(LogCategory::Map, "Current map: {} ({})", mapManager.getCurrentMapNumber(), mapName);
+        LOG_INFO(LogCategory::Map, "Press 1-9 to switch maps");
 
         infoPrinted = true;
     }
+}
 
-    // Draw debug visualization for collision detection
-    sf::CircleShape debugPoint(3.0f);
-    debugPoint.setFillColor(sf::Color::Red);
+// Audio functions have been moved to the SFX class
 
-    // Draw the center point of the player for collision detection
-    float centerX = playerSprite.getPosition().x + playerSprite.getGlobalBounds().size.x / 2;
-    float centerY = playerSprite.getPosition().y + playerSprite.getGlobalBounds().size.y / 2;
-    debugPoint.setPosition(sf::Vector2f(centerX, centerY));
+// A numeric command line value. Anything that is not a whole non-negative number (or a
+// decimal one for floating point options) is warned about and leaves value as it was.
+template <typename T>
+void parseNumberOption(const std::string& option, const char* text, T& value) {
+    T parsed{};
+    const char* end = text + std::strlen(text);
+    bool valid;
+    if constexpr (std::is_floating_point_v<T>) {
+        char* parsedEnd = nullptr;
+        parsed = static_cast<T>(std::strtod(text, &parsedEnd));
+        valid = parsedEnd != text && parsedEnd == end && std::isfinite(parsed) && parsed >= 0;
+    } else {
+        auto [parsedEnd, error] = std::from_chars(text, end, parsed);
+        valid = error == std::errc() && parsedEnd == end && parsed >= 0;
+    }
+    if (!valid) {
+        LOG_WARNING(LogCategory::Game, "Ignoring {} {}: expected a number, keeping {}", option, text, value);
+        return;
+    }
+    value = parsed;
+}
 
+// Frame times of a replay, and whether it ended in the state the recording did
+void reportReplay(const ReplayPlayer& replay, const FrameStats& frameStats) {
+    logger().flush();
+    frameStats.print("Replay");
+    uint64_t checksum = world.checksum();
+    if (replay.getStep() < replay.getStepCount()) {
+        std::cerr << "Replay stopped after " << replay.getStep() << " of " << replay.getStepCount() << " steps" << std::endl;
+    } else if (replay.getFinalChecksum() != 0 && checksum != replay.getFinalChecksum()) {
+        std::cerr << "Replay diverged: checksum " << std::hex << checksum << ", recorded " << replay.getFinalChecksum() << std::dec << std::endl;
+    } else {
+        std::cout << "Replay matched, checksum " << std::hex << checksum << std::dec << std::endl;
+    }
 }
 
-// Audio functions have been moved to the SFX class
+#ifndef ASHVALE_HEADLESS
 
 // Add font and text variables after the global variables
 sf::Font gameFont;
-sf::Text scoreText(gameFont);
-sf::Text mapText(gameFont);
+Hud hud;
 sf::Text titleText(gameFont);
 sf::Text pressStartText(gameFont);
-bool gameStarted = false;
 float titleAlpha = 0.f;
 float pressStartAlpha = 0.f;
 sf::Clock titleClock;
 
 sf::Text levelClearedText(gameFont);
 sf::Text pressContinueText(gameFont);
-bool levelCleared = false;
 float levelClearedAlpha = 0.f;
 float pressContinueAlpha = 0.f;
 sf::Clock levelClearedClock;
@@ -1504,33 +1629,359 @@ sf::Clock levelClearedClock;
 sf::Text gameOverText(gameFont);
 sf::Text finalScoreText(gameFont);
 sf::Text pressExitText(gameFont);
-bool gameOver = false;
 float gameOverAlpha = 0.f;
 float pressExitAlpha = 0.f;
 sf::Clock gameOverClock;
 
 
 sf::Text toBeContinuedText(gameFont);
-bool toBeContinued = false;
 float toBeContinuedAlpha = 0.f;
 sf::Clock toBeContinuedClock;
 
-int main()  
+// The screen the render thread last drew; the texts above belong to the render thread
+World::Screen shownScreen = World::Screen::Title;
+
+// Everything the render thread needs for one frame, as plain data: the visible world
+// recorded as quads (tiles and sprites, already culled, in draw order), which screen is
+// up and the HUD values. The simulation fills one while the last one is being drawn.
+struct FramePacket {
+    World::Screen screen = World::Screen::Title;
+    sf::View worldView;         // Camera
+    SpriteBatch world;          // Map, enemies, player and sword
+    int score = 0;
+    int level = 0;
+    int health = 0;
+    bool showProfiler = false;
+    bool showCounters = false;
+    bool showFrameTimes = false;
+    bool startCapture = false;  // F4; the profiler is drained on the render thread
+    std::optional<InputSampler::Clock::time_point> inputSeen;  // Oldest input these ticks used; --input-latency
+};
+
+// Frame time percentiles, F6; render thread
+sf::Text frameTimeText(gameFont);
+
+// Time from launch to the title screen that startup should stay under
+const sf::Time STARTUP_BUDGET = sf::milliseconds(1500);
+
+// GL-thread work (uploads, sprite setup) allowed per loading-screen frame
+const sf::Time LOADING_TIME_SLICE = sf::milliseconds(8);
+
+// Progress bar shown while the startup jobs run
+void drawLoadingScreen(sf::RenderWindow& window, const StartupLoader& loader) {
+    const sf::Vector2f barSize(600.f, 24.f);
+    const sf::Vector2f barPosition(window.getSize().x / 2.f - barSize.x / 2.f, window.getSize().y * 2.f / 3.f);
+
+    sf::RectangleShape outline(barSize);
+    outline.setPosition(barPosition);
+    outline.setFillColor(sf::Color::Transparent);
+    outline.setOutlineColor(sf::Color::Black);
+    outline.setOutlineThickness(2.f);
+
+    sf::RectangleShape fill(sf::Vector2f(barSize.x * loader.getProgress(), barSize.y));
+    fill.setPosition(barPosition);
+    fill.setFillColor(sf::Color::Black);
+
+    sf::Text status(gameFont, "Loading " + loader.getStatus() + "...", 24);
+    status.setFillColor(sf::Color::Black);
+    status.setPosition(sf::Vector2f(barPosition.x, barPosition.y - 40.f));
+
+    window.clear(sf::Color::White);
+    window.draw(titleText);
+    window.draw(outline);
+    window.draw(fill);
+    window.draw(status);
+    window.display();
+}
+
+void showFinalScore(const sf::RenderWindow& window, int score) {
+    finalScoreText.setString("FINAL SCORE " + std::to_string(score));
+    finalScoreText.setPosition(sf::Vector2f(
+        window.getSize().x / 2.f - finalScoreText.getGlobalBounds().size.x / 2.f,
+        window.getSize().y / 2.f
+    ));
+}
+
+// Start the fade-in of the screen the simulation just switched to
+void enterScreen(World::Screen screen, const sf::RenderWindow& window, int score) {
+    switch (screen) {
+    case World::Screen::LevelCleared:
+        levelClearedClock.restart();
+        levelClearedAlpha = 0.f;
+        pressContinueAlpha = 0.f;
+        break;
+    case World::Screen::GameOver:
+        gameOverClock.restart();
+        gameOverAlpha = 0.f;
+        pressExitAlpha = 0.f;
+        showFinalScore(window, score);
+        break;
+    case World::Screen::ToBeContinued:
+        toBeContinuedClock.restart();
+        toBeContinuedAlpha = 0.f;
+        pressExitAlpha = 0.f;
+        showFinalScore(window, score);
+        break;
+    default:
+        break;
+    }
+}
+
+// Render thread: draws one packet. Starts the fade-in of a screen the simulation just
+// switched to.
+void renderFrame(sf::RenderWindow& window, WorldRenderTarget& worldTarget, FramePacket& packet) {
+    if (packet.screen != shownScreen) {
+        enterScreen(packet.screen, window, packet.score);
+        shownScreen = packet.screen;
+    }
+
+    // Clear the window  
+    window.clear(sf::Color::White);  
+
+    if (packet.screen == World::Screen::Title) {
+        // Title screen animation
+        float elapsed = titleClock.getElapsedTime().asSeconds();
+        
+        // Fade in title
+        if (titleAlpha < 255.f) {
+            titleAlpha = std::min(255.f, elapsed * 100.f);
+            titleText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(titleAlpha)));
+        }
+        
+        // Blink "Press Start" text
+        pressStartAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
+        pressStartText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressStartAlpha)));
+
+        // Draw title screen
+        window.draw(titleText);
+        window.draw(pressStartText);
+    } else if (packet.screen == World::Screen::LevelCleared) {
+        // Level cleared screen animation
+        float elapsed = levelClearedClock.getElapsedTime().asSeconds();
+        
+        // Fade in level cleared text
+        if (levelClearedAlpha < 255.f) {
+            levelClearedAlpha = std::min(255.f, elapsed * 100.f);
+            levelClearedText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(levelClearedAlpha)));
+        }
+        
+        // Blink "Press Continue" text
+        pressContinueAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
+        pressContinueText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressContinueAlpha)));
+
+        // Draw level cleared screen
+        window.draw(levelClearedText);
+        window.draw(pressContinueText);
+    } else if (packet.screen == World::Screen::GameOver) {
+        // Game over screen animation
+        float elapsed = gameOverClock.getElapsedTime().asSeconds();
+        
+        // Fade in game over text
+        if (gameOverAlpha < 255.f) {
+            gameOverAlpha = std::min(255.f, elapsed * 100.f);
+            gameOverText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(gameOverAlpha)));
+            finalScoreText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(gameOverAlpha)));
+        }
+        
+        // Blink "Press Exit" text
+        pressExitAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
+        pressExitText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressExitAlpha)));
+
+        // Draw game over screen
+        window.draw(gameOverText);
+        window.draw(finalScoreText);
+        window.draw(pressExitText);
+    } else if (packet.screen == World::Screen::ToBeContinued) {
+        // To be continued screen animation
+        float elapsed = toBeContinuedClock.getElapsedTime().asSeconds();
+        
+        // Fade in to be continued text
+        if (toBeContinuedAlpha < 255.f) {
+            toBeContinuedAlpha = std::min(255.f, elapsed * 100.f);
+            toBeContinuedText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(toBeContinuedAlpha)));
+            finalScoreText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(toBeContinuedAlpha)));
+        }
+        
+        // Blink "Press Exit" text
+        pressExitAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
+        pressExitText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressExitAlpha)));
+
+        // Draw to be continued screen
+        window.draw(toBeContinuedText);
+        window.draw(finalScoreText);
+        window.draw(pressExitText);
+    } else {
+        // The world goes to the low resolution target when there is one. Tiles and
+        // sprites share the atlas, so this is one draw call per page
+        if (worldTarget.isActive()) {
+            packet.world.flush(worldTarget.begin(packet.worldView, sf::Color::White));
+            worldTarget.present(window);
+        } else {
+            window.setView(packet.worldView);
+            packet.world.flush(window);
+        }
+
+        // HUD is drawn in screen space
+        PROFILE_ZONE("HUD");
+        window.setView(window.getDefaultView());
+
+        // Score, level and health; rebuilt only when they change
+        hud.update(packet.score, packet.level, packet.health);
+        hud.draw(window);
+    }
+
+    if (packet.showProfiler || packet.showCounters) {
+        window.setView(window.getDefaultView());
+    }
+    if (packet.showProfiler) {
+        profiler().drawOverlay(window, gameFont);
+    }
+    if (packet.showCounters) {
+        counters().drawOverlay(window, gameFont, sf::Vector2f(8.f, window.getSize().y / 2.f));
+    }
+}
+
+// Draws whatever the simulation hands over until the handoff is closed, so a slow
+// display() no longer holds up input and AI. This thread owns the GL context from here
+// on; events are still polled on the main thread, which is where SFML wants them.
+void renderLoop(sf::RenderWindow& window, WorldRenderTarget& worldTarget, FrameHandoff<FramePacket>& handoff) {
+    if (!window.setActive(true)) {
+        LOG_ERROR(LogCategory::Game, "Render thread could not take the GL context");
+    }
+
+    // Time between presented frames: what the player actually sees
+    FrameTimeHistogram frameTimes;
+    FrameTimeHistogram inputLatency;
+    sf::Clock presentClock;
+    sf::Clock logClock;
+    int framesSinceText = 0;
+    frameTimeText.setCharacterSize(18);
+    frameTimeText.setFillColor(sf::Color::White);
+    frameTimeText.setOutlineColor(sf::Color::Black);
+    frameTimeText.setOutlineThickness(1.f);
+    frameTimeText.setPosition(sf::Vector2f(8.f, window.getSize().y - 28.f));
+
+    while (FramePacket* packet = handoff.acquire()) {
+        if (packet->startCapture) {
+            profiler().startCapture("AshVale-trace.json", 300);
+        }
+        int64_t workStart = profileNow();
+        {
+            PROFILE_ZONE("render");
+            renderFrame(window, worldTarget, *packet);
+        }
+        if (packet->showFrameTimes) {
+            // Rebuilt twice a second; setString lays out every glyph
+            if (framesSinceText++ % 30 == 0) {
+                std::string text = "frame " + frameTimes.summary();
+                if (inputLatency.getCount() > 0) text += "\ninput to present " + inputLatency.summary();
+                frameTimeText.setString(text);
+                frameTimeText.setPosition(sf::Vector2f(8.f, window.getSize().y - 8.f - frameTimeText.getGlobalBounds().size.y));
+            }
+            window.setView(window.getDefaultView());
+            window.draw(frameTimeText);
+        }
+        // display() waits for vsync, so it is not counted as work
+        profiler().reportRenderWork(profileNow() - workStart);
+        {
+            PROFILE_ZONE("display");
+            window.display();
+        }
+        frameTimes.add(presentClock.restart());
+        // display() has handed the frame over, which is as close to "on screen" as we can see
+        if (packet->inputSeen) {
+            inputLatency.add(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(InputSampler::Clock::now() - *packet->inputSeen).count()));
+        }
+        PROFILE_FRAME();
+        COUNTERS_FRAME();
+
+        if (logClock.getElapsedTime() >= sf::seconds(10.f)) {
+            LOG_INFO(LogCategory::Game, "Frame times over the last {} frames: {}", frameTimes.getCount(), frameTimes.summary());
+            if (inputLatency.getCount() > 0) {
+                LOG_INFO(LogCategory::Game, "Input to present over the last {} inputs: {}", inputLatency.getCount(), inputLatency.summary());
+            }
+            logClock.restart();
+        }
+    }
+    LOG_INFO(LogCategory::Game, "Frame times over the last {} frames: {}", frameTimes.getCount(), frameTimes.summary());
+    if (inputLatency.getCount() > 0) {
+        LOG_INFO(LogCategory::Game, "Input to present over the last {} inputs: {}", inputLatency.getCount(), inputLatency.summary());
+    }
+    (void)window.setActive(false);
+}
+
+//   AshVale [--record file]   save this session's input for replays
+//   AshVale [--replay file]   play a recorded session back, uncapped, and report frame times
+//   AshVale [--counters file] append the performance counters to a JSON lines file every 10 s
+//   AshVale [--pixel-scale N] draw the world at 1/N resolution and upscale it (3: 427x240)
+//   AshVale [--fps N|vsync]   frame rate to pace to (default 60, 0 for uncapped), or follow vsync
+//   AshVale [--late-input 0]  don't re-read held buttons right before the player moves
+//   AshVale [--input-latency 1] measure input to present time (F6 and the log)
+int main(int argc, char* argv[])
 {  
-   // Initialize random seed  
-   srand(static_cast<unsigned int>(time(nullptr)));  
+   sf::Clock startupClock;
+
+   std::string recordPath;
+   std::string replayPath;
+   unsigned int pixelScale = 1;
+   double frameRate = 60.0;
+   bool vsync = false;
+   bool lateInput = true;
+   bool measureLatency = false;
+   for (int i = 1; i + 1 < argc; i += 2) {
+       std::string arg = argv[i];
+       if (arg == "--record") recordPath = argv[i + 1];
+       else if (arg == "--replay") replayPath = argv[i + 1];
+       else if (arg == "--counters") counters().startDump(argv[i + 1], std::chrono::seconds(10));
+       else if (arg == "--pixel-scale") parseNumberOption(arg, argv[i + 1], pixelScale);
+       else if (arg == "--fps") {
+           if (std::string(argv[i + 1]) == "vsync") vsync = true;
+           else parseNumberOption(arg, argv[i + 1], frameRate);
+       }
+       else if (arg == "--late-input") lateInput = std::string(argv[i + 1]) != "0";
+       else if (arg == "--input-latency") measureLatency = std::string(argv[i + 1]) != "0";
+   }
+   bool recording = !recordPath.empty();
+   bool replaying = !replayPath.empty();
+   ReplayPlayer replay;
+   if (replaying && !replay.load(replayPath)) return 1;
+
+   // Initialize random seed; a replay reuses the recorded one
+   uint64_t seed = replaying ? replay.getSeed() : static_cast<uint64_t>(time(nullptr));
+   world.random.reseed(seed);
+   int firstMap = replaying ? replay.getStartMap() : 1;
+   ReplayRecorder recorder;
+   if (recording) recorder.begin(seed, firstMap);
+   // Recorded sessions must not depend on how fast chunks happen to stream in
+   world.waitForStreaming = recording || replaying;
 
    // Initialize  
    sf::ContextSettings settings;  
-   settings.antiAliasingLevel = 8;  
+   // Pixel art gains nothing from multisampling once the world is upscaled
+   settings.antiAliasingLevel = pixelScale > 1 ? 0 : 8;
 
    sf::RenderWindow window(sf::VideoMode({ 1280,720 }), "AshVale", sf::Style::Default, sf::State::Windowed, settings);
-   window.setFramerateLimit(60);
+   // Frames are paced by FramePacer rather than setFramerateLimit's plain sleep, or by
+   // vsync on request. Uncapped for replays, so frame times measure the frame and not
+   // the pacing
+   window.setVerticalSyncEnabled(vsync && !replaying);
+   FramePacer pacer(vsync || replaying ? 0.0 : frameRate);
+   // A frame that needs more work than its period (60 fps when uncapped or on vsync)
+   // makes waves spawn more slowly
+   profiler().setFrameBudget(1000.0 / (pacer.getTargetRate() > 0.0 ? pacer.getTargetRate() : 60.0));
+
+   WorldRenderTarget worldTarget;
+   if (pixelScale > 1 && !worldTarget.create(window.getSize(), pixelScale)) {
+       LOG_WARNING(LogCategory::Game, "Could not create the {}x low resolution world target, drawing at full resolution", pixelScale);
+   }
 
-   bool gameRunning = true;  
+   // One pack instead of dozens of loose files, when it has been built
+   if (!assetPack().open(ASSET_PACK_FILE)) {
+       std::cout << "No asset pack, loading loose files from Assets" << std::endl;
+   }
 
    // Load font
-   if (!gameFont.openFromFile("Assets/Font/PIXBOB MINI LITE.ttf")) {
+   if (!openFontAsset(gameFont, "Assets/Font/PIXBOB MINI LITE.ttf")) {
        std::cerr << "Failed to load font!" << std::endl;
        return 1;
    }
@@ -1553,18 +2004,6 @@ int main()
        window.getSize().y * 2.f / 3.f
    ));
 
-   // Set up score text
-   scoreText.setCharacterSize(32);
-   scoreText.setFillColor(sf::Color::Black);
-   scoreText.setPosition(sf::Vector2f(window.getSize().x - 200.f, 40.f));
-   scoreText.setString("Score: 0");
-
-   // Level text
-   mapText.setCharacterSize(32);
-   mapText.setFillColor(sf::Color::Black);
-   mapText.setPosition(sf::Vector2f(window.getSize().x - 200.f, 70.f));
-   mapText.setString("Level: 1");
-
    // Set up level cleared text
    levelClearedText.setCharacterSize(64);
    levelClearedText.setFillColor(sf::Color::Black);
@@ -1618,266 +2057,390 @@ int main()
        window.getSize().y / 3.f
    ));
 
-   // Load map tilesheet  
-   std::string tilesheetPath = forestTilesheet;
-   if (!mapTilesheet.loadFromFile(tilesheetPath)) {  
-       std::cerr << "Failed to load map tilesheet: " << tilesheetPath << std::endl;  
-       return 1;  
-   }  
-
-   // Create weapon instance  
-   Weapon sword("Assets/32 Free Weapon Icons/Icons/Iicon_32_38.png");  
+   // Load everything else in parallel while a progress bar is shown:
+   //   sprite atlas (decode on a worker, upload here) -> player -> map 1 (built on a worker, swapped in here)
+   //   audio, alongside the rest
+   StartupLoader loader(workerPool());
+   unsigned int atlasPageSize = std::min(2048u, sf::Texture::getMaximumSize());
+   StartupLoader::JobId atlasJob = loader.add("sprite atlas",
+       [atlasPageSize] { return prepareSpriteAtlas(atlasPageSize); },
+       [] { return uploadSpriteAtlas(); });
+   StartupLoader::JobId playerJob = loader.add("player", {},
+       [] { player.renderPlayer(); return true; },
+       { atlasJob });
+   PreparedLevel firstLevel;
+   unsigned int firstLevelSeed = world.random.next();
+   StartupLoader::JobId levelJob = loader.add("map " + std::to_string(firstMap),
+       // Spawn rules depend on the player's sprite size, hence after the player
+       [&firstLevel, firstMap, firstLevelSeed] { firstLevel = levelLoader.take(firstMap, levelSpawnRules(), firstLevelSeed); return firstLevel.loaded; },
+       // Places the player and spawns the initial enemies
+       [&firstLevel] { return startLevel(std::move(firstLevel)); },
+       { playerJob });
+   loader.add("audio", [] { sfx.initializeAudio(); return sfx.isMusicLoaded(); });
+
+   loader.start();
+   while (!loader.update(LOADING_TIME_SLICE)) {
+       while (const std::optional event = window.pollEvent()) {
+           if (event->is<sf::Event::Closed>()) {
+               window.close();
+               return 0;
+           }
+       }
+       drawLoadingScreen(window, loader);
+   }
 
-   // Load initial map  
-   if (!mapManager.loadMap(1)) {
+   if (!loader.succeeded(levelJob)) {
        std::cerr << "Failed to load initial map!" << std::endl;
        return 1;
    }
+   if (!mapTilesheet.isValid()) {
+       std::cerr << "Failed to load map tilesheet: " << tilesheetForMap(firstMap) << std::endl;
+       return 1;
+   }
 
-   // Load player  
-   player.renderPlayer();  
-   playerSprite.setPosition({100, 100}); // Set initial player position
-   
-   // Initialize audio
-   sfx.initializeAudio();
-   
-   // Spawn initial enemies only once at the start
-   for (int i = 0; i < 5; ++i) {
-       spawnEnemy();
+   // Score, level and hearts
+   hud.setup(gameFont, window.getSize(), spriteAtlas.find("Assets/UI/HeartIcons_32x32.png"));
+
+   // Create weapon instance  
+   Weapon sword(spriteAtlas.find("Assets/32 Free Weapon Icons/Icons/Iicon_32_38.png"));  
+
+   sf::Time startupTime = startupClock.getElapsedTime();
+   logger().flush();
+   std::cout << "Startup took " << startupTime.asMilliseconds() << " ms (budget " << STARTUP_BUDGET.asMilliseconds() << " ms)" << std::endl;
+   loader.printReport();
+   if (startupTime > STARTUP_BUDGET) {
+       std::cerr << "Startup is over budget by " << (startupTime - STARTUP_BUDGET).asMilliseconds() << " ms!" << std::endl;
    }
 
+   FrameStats frameStats;
+   sf::Clock frameClock;
+   bool showProfiler = false;
+   bool showCounters = false;
+   bool showFrameTimes = false;
+   bool startCapture = false;
+   DepthSorter depthSorter;
+
+   // Fixed-step simulation: each frame runs as many ticks as real time has covered, so
+   // game speed no longer follows the frame rate. The lag starts at half a tick so that
+   // at 60 fps, with frames paced to the tick, the usual jitter never tips a frame into
+   // running zero ticks and the next two
+   using SimClock = FramePacer::Clock;
+   const SimClock::duration SIM_TICK = std::chrono::duration_cast<SimClock::duration>(std::chrono::duration<double>(1.0 / SIM_TICK_RATE));
+   const int MAX_TICKS_PER_FRAME = 4;  // After a hitch the rest is dropped rather than caught up
+   SimClock::duration simLag = SIM_TICK / 2;
+   SimClock::time_point lastFrameStart = SimClock::now();
+   InputFrame presses;  // Confirm and map keys wait here for the next tick
+   InputSampler sampler;
+   // A replay's buttons come from the file
+   if (lateInput && !replaying) {
+       world.resampleHeld = [&sampler] { return sampler.sampleHeld(); };
+   }
+
+   // From here on the render thread draws; this one polls events and runs the simulation
+   FrameHandoff<FramePacket> handoff;
+   (void)window.setActive(false);
+   std::thread renderThread(renderLoop, std::ref(window), std::ref(worldTarget), std::ref(handoff));
+
    // Game Loop (infinite loop)  
-   while (window.isOpen())  
+   bool running = true;
+   while (running)  
    {  
+       pacer.wait();
+       frameClock.restart();
+
+       // The render thread has to have taken the last frame before this one can be
+       // handed over; waiting here rather than after the ticks means the input they run
+       // on is read after the wait, not before it
+       {
+           PROFILE_ZONE("wait for render");
+           handoff.waitUntilTaken();
+       }
+       // This thread's work for the frame starts after the pacing and the wait
+       int64_t workStart = profileNow();
+
        // Event handling  
-       while (const std::optional event = window.pollEvent())
+       {
+        PROFILE_ZONE("events");
+        while (const std::optional event = window.pollEvent())
         {
             if (event->is<sf::Event::Closed>())
-                window.close();
-
-            // Handle space key to start game, continue after level cleared, or exit after game over/to be continued
-            if ((!gameStarted || levelCleared || gameOver || toBeContinued) && event->is<sf::Event::KeyPressed>()) {
-                const auto& keyEvent = *event->getIf<sf::Event::KeyPressed>();
-                if (keyEvent.code == sf::Keyboard::Key::Space) {
-                    if (!gameStarted) {
-                        gameStarted = true;
-                    } else if (levelCleared) {
-                        levelCleared = false;
-                        loadNextMap();
-                    } else if (gameOver || toBeContinued) {
-                        gameRunning = false;  // Set gameRunning to false to exit the game loop
-                        window.close();      // Close the window
-                        break;               // Break out of the event loop
-                    }
+                running = false;
+
+            if (event->is<sf::Event::MouseButtonPressed>())
+                sampler.notice();
+
+            if (const auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
+                sampler.notice();
+#if ASHVALE_PROFILING
+                // F3 shows zone timings, F4 captures the next 300 frames as a Chrome trace
+                if (keyEvent->code == sf::Keyboard::Key::F3) {
+                    showProfiler = !showProfiler;
+                }
+                if (keyEvent->code == sf::Keyboard::Key::F4) {
+                    startCapture = true;
+                }
+                // F5 shows the performance counters
+                if (keyEvent->code == sf::Keyboard::Key::F5) {
+                    showCounters = !showCounters;
+                }
+#endif
+
+                // F6 shows frame time percentiles
+                if (keyEvent->code == sf::Keyboard::Key::F6) {
+                    showFrameTimes = !showFrameTimes;
+                }
+
+                // Space starts the game, continues after level cleared, or exits after game over/to be continued
+                if (keyEvent->code == sf::Keyboard::Key::Space) {
+                    presses.confirm = true;
                 }
-            }
 
-            // Handle map switching with number keys 
-            if (event->is<sf::Event::KeyPressed>()) {
-                const auto& keyEvent = *event->getIf<sf::Event::KeyPressed>();
-                if (keyEvent.code >= sf::Keyboard::Key::Num0 && keyEvent.code <= sf::Keyboard::Key::Num9) {
-                    int mapNumber = static_cast<int>(keyEvent.code) - static_cast<int>(sf::Keyboard::Key::Num0);
+                // Map switching with number keys
+                if (keyEvent->code >= sf::Keyboard::Key::Num0 && keyEvent->code <= sf::Keyboard::Key::Num9) {
+                    int mapNumber = static_cast<int>(keyEvent->code) - static_cast<int>(sf::Keyboard::Key::Num0);
                     if (mapNumber == 0) mapNumber = 10; // Handle 0 key as map 10
-                    
-                    // Save current player position
-                    sf::Vector2f currentPlayerPos = playerSprite.getPosition();
-                    
-                    // Set correct tilesheet for the map
-                    std::string newTilesheetPath = forestTilesheet;
-                    if (mapNumber == 2) {
-                        newTilesheetPath = tundraTilesheet;
-                    }
-                    if (!mapTilesheet.loadFromFile(newTilesheetPath)) {
-                        std::cerr << "Failed to load map tilesheet: " << newTilesheetPath << std::endl;
-                    }
-                    
-                    // Try to load the new map
-                    if (mapManager.loadMap(mapNumber)) {
-                        // Reset player position to a safe starting position
-                        playerSprite.setPosition({100, 100});
-                        
-                        // Clear existing enemies
-                        enemies.clear();
-                        
-                        // Spawn new enemies for the new map
-                        for (int i = 0; i < 5; ++i) {
-                            spawnEnemy();
-                        }
-                        
-                        std::cout << "Successfully switched to map " << mapNumber << std::endl;
-                    } else {
-                        // If map loading failed, restore player position
-                        playerSprite.setPosition(currentPlayerPos);
-                        std::cerr << "Failed to load map " << mapNumber << std::endl;
-                    }
+                    presses.mapKey = static_cast<uint8_t>(mapNumber);
                 }
             }
         }
+       }
 
-       // Clear the window  
-       window.clear(sf::Color::White);  
+       // Held buttons are read after the events, right before the ticks
+       InputFrame input;
+       input.held = sampler.sampleHeld();
+
+       // A replay runs exactly one tick a frame
+       int ticks = 1;
+       if (!replaying) {
+           SimClock::time_point now = SimClock::now();
+           simLag = std::min(simLag + (now - lastFrameStart), SIM_TICK * MAX_TICKS_PER_FRAME);
+           lastFrameStart = now;
+           ticks = static_cast<int>(simLag / SIM_TICK);
+           simLag -= SIM_TICK * ticks;
+       }
 
-       if (!gameRunning) {  // Check if game should stop
-           break;           // Break out of the main game loop
+       // Wall clock timing must not steer a run that has to be reproducible
+       if (!recording && !replaying) {
+           world.frameLoad = profiler().getFrameLoad();
        }
 
-       if (!gameStarted) {
-           // Title screen animation
-           float elapsed = titleClock.getElapsedTime().asSeconds();
-           
-           // Fade in title
-           if (titleAlpha < 255.f) {
-               titleAlpha = std::min(255.f, elapsed * 100.f);
-               titleText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(titleAlpha)));
+       for (int tick = 0; tick < ticks && running; ++tick) {
+           // Held buttons apply to every tick, presses to the first
+           InputFrame tickInput = input;
+           tickInput.confirm = presses.confirm;
+           tickInput.mapKey = presses.mapKey;
+           presses = InputFrame();
+
+           // A replay ignores the keyboard and ends with the recording
+           if (replaying) {
+               if (replay.isFinished()) {
+                   running = false;
+                   break;
+               }
+               tickInput = replay.next();
            }
-           
-           // Blink "Press Start" text
-           pressStartAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
-           pressStartText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressStartAlpha)));
-
-           // Draw title screen
-           window.draw(titleText);
-           window.draw(pressStartText);
-       } else if (levelCleared) {
-           // Level cleared screen animation
-           float elapsed = levelClearedClock.getElapsedTime().asSeconds();
-           
-           // Fade in level cleared text
-           if (levelClearedAlpha < 255.f) {
-               levelClearedAlpha = std::min(255.f, elapsed * 100.f);
-               levelClearedText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(levelClearedAlpha)));
+
+           {
+               PROFILE_ZONE("simulation");
+               world.step(tickInput);
            }
-           
-           // Blink "Press Continue" text
-           pressContinueAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
-           pressContinueText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressContinueAlpha)));
-
-           // Draw level cleared screen
-           window.draw(levelClearedText);
-           window.draw(pressContinueText);
-       } else if (gameOver) {
-           // Game over screen animation
-           float elapsed = gameOverClock.getElapsedTime().asSeconds();
-           
-           // Fade in game over text
-           if (gameOverAlpha < 255.f) {
-               gameOverAlpha = std::min(255.f, elapsed * 100.f);
-               gameOverText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(gameOverAlpha)));
-               finalScoreText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(gameOverAlpha)));
+           // What the tick ran with, re-read buttons included, so replays match
+           if (recording) recorder.record(world.lastInput);
+           if (world.quitRequested) {
+               running = false;
            }
-           
-           // Blink "Press Exit" text
-           pressExitAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
-           pressExitText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressExitAlpha)));
-
-           // Draw game over screen
-           window.draw(gameOverText);
-           window.draw(finalScoreText);
-           window.draw(pressExitText);
-       } else if (toBeContinued) {
-           // To be continued screen animation
-           float elapsed = toBeContinuedClock.getElapsedTime().asSeconds();
-           
-           // Fade in to be continued text
-           if (toBeContinuedAlpha < 255.f) {
-               toBeContinuedAlpha = std::min(255.f, elapsed * 100.f);
-               toBeContinuedText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(toBeContinuedAlpha)));
-               finalScoreText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(toBeContinuedAlpha)));
+       }
+       if (!running) break;
+
+       // Record the frame for the render thread, which is still drawing the previous one
+       {
+           PROFILE_ZONE("record");
+           FramePacket& packet = handoff.back();
+           packet.screen = world.screen;
+           packet.world.clear();
+           packet.score = player.score;
+           packet.level = mapManager.getCurrentMapNumber();
+           packet.health = player.health;
+           packet.showProfiler = showProfiler;
+           packet.showCounters = showCounters;
+           packet.showFrameTimes = showFrameTimes;
+           packet.inputSeen.reset();
+           if (ticks > 0) {
+               std::optional<InputSampler::Clock::time_point> seen = sampler.takeSeen();
+               if (measureLatency) packet.inputSeen = seen;
            }
-           
-           // Blink "Press Exit" text
-           pressExitAlpha = 128.f + 127.f * std::sin(elapsed * 2.f);
-           pressExitText.setFillColor(sf::Color(0, 0, 0, static_cast<uint8_t>(pressExitAlpha)));
-
-           // Draw to be continued screen
-           window.draw(toBeContinuedText);
-           window.draw(finalScoreText);
-           window.draw(pressExitText);
-       } else {
-           player.playerMovement();  
-
-           // Remove dead enemies that have finished their death animation  
-           enemies.remove_if([](Enemy& e) { return !e.isAlive && e.isDeathAnimationComplete(); });  
-
-           // Check if all enemies are dead and load next map if so
-           if (areAllEnemiesDead() && enemies.empty()) {
-               if (mapManager.getCurrentMapNumber() == 1) {
-                   levelCleared = true;
-                   levelClearedClock.restart();
-                   levelClearedAlpha = 0.f;
-                   pressContinueAlpha = 0.f;
-               } else if (mapManager.getCurrentMapNumber() == 2) {
-                   toBeContinued = true;
-                   toBeContinuedClock.restart();
-                   toBeContinuedAlpha = 0.f;
-                   pressExitAlpha = 0.f;
-                   finalScoreText.setString("FINAL SCORE " + std::to_string(player.score));
-                   finalScoreText.setPosition(sf::Vector2f(
-                       window.getSize().x / 2.f - finalScoreText.getGlobalBounds().size.x / 2.f,
-                       window.getSize().y / 2.f
-                   ));
-                   std::cout << "Level 2 cleared! Showing To Be Continued screen..." << std::endl;
-               } else {
-                   loadNextMap();
+           packet.startCapture = startCapture;
+           startCapture = false;
+
+           if (world.screen == World::Screen::Playing) {
+               // The simulation keeps the camera on the player
+               packet.worldView = camera.getView();
+               sf::FloatRect visibleArea = worldTarget.isActive() ? worldTarget.snap(camera.getView()) : camera.getVisibleArea();
+
+               // Queue the visible part of the map as background  
+               mapManager.draw(packet.world, mapTilesheet, visibleArea);  
+
+               // Update sword  
+               sword.updatePosition(playerSprite.getPosition(), playerSprite.getGlobalBounds().size);  
+               sword.updateSwing(player.isAttacking);  
+
+               // Enemies on screen and the player, back to front by where their feet are, so
+               // a slime walking below the player is drawn over them. The player goes in last
+               // and wins ties, as when it was always drawn on top
+               {
+                   PROFILE_ZONE("depth sort");
+                   FrameVector<const sf::Sprite*> sprites{ FrameAllocator<const sf::Sprite*>() };
+                   depthSorter.clear();
+                   for (const auto& enemy : world.enemies) {  
+                       if (const sf::Sprite* sprite = enemy.getVisibleSprite(camera)) {
+                           depthSorter.add(sprite->getGlobalBounds().position.y + sprite->getGlobalBounds().size.y, static_cast<uint32_t>(sprites.size()));
+                           sprites.push_back(sprite);
+                       }
+                   }  
+                   const uint32_t playerIndex = static_cast<uint32_t>(sprites.size());
+                   depthSorter.add(playerSprite.getGlobalBounds().position.y + playerSprite.getGlobalBounds().size.y, playerIndex);
+                   sprites.push_back(&playerSprite);
+
+                   for (const DepthItem& item : depthSorter.sort()) {
+                       packet.world.draw(*sprites[item.index]);
+                       // The sword is held, so it sits right over its owner
+                       if (item.index == playerIndex) sword.draw(packet.world);
+                   }
                }
-           }
 
-           // Update and check all enemies  
-           for (auto& enemy : enemies) {  
-               enemy.enemyMovement(playerSprite.getPosition());  
-               updateHitBox(player, enemy);  
-           }  
-
-           // Heal the player if applicable  
-           updateHealing(player);  
-
-           // Check if the player is dead  
-           if (player.isDead && player.deathAnimationComplete) {  
-               gameOver = true;
-               gameOverClock.restart();
-               gameOverAlpha = 0.f;
-               pressExitAlpha = 0.f;
-               finalScoreText.setString("FINAL SCORE " + std::to_string(player.score));
-               finalScoreText.setPosition(sf::Vector2f(
-                   window.getSize().x / 2.f - finalScoreText.getGlobalBounds().size.x / 2.f,
-                   window.getSize().y / 2.f
-               ));
-           }  
-
-           // Update text content
-           scoreText.setString("Score: " + std::to_string(player.score));
-           mapText.setString("Level: " + std::to_string(mapManager.getCurrentMapNumber()));
-
-           // Draw the map as background  
-           mapManager.draw(window, mapTilesheet);  
-
-           // Draw all enemies  
-           for (auto& enemy : enemies) {  
-               enemy.draw(window);  
-           }  
-
-           window.draw(playerSprite);  
-
-           // Draw the player's health  
-           player.playerHealth(window);  
-
-           // Draw text
-           window.draw(scoreText);
-           window.draw(mapText);
-
-           // Update and draw sword  
-           sf::Vector2f mousePos = sf::Vector2f(sf::Mouse::getPosition(window));  
-           
-           sword.updatePosition(playerSprite.getPosition(), playerSprite.getGlobalBounds().size);  
-           sword.updateSwing(player.isAttacking);  
-           sword.draw(window);  
-
-           // Draw map information  
-           drawMapInfo(window, mapManager);  
+               // Draw map information  
+               drawMapInfo(mapManager);  
+           }
        }
 
-       window.display();  
+       handoff.publish();
+       profiler().reportSimulationWork(profileNow() - workStart);
+       frameStats.add(frameClock.getElapsedTime());
+       frameArena().reset();
    }  
 
+   handoff.close();
+   renderThread.join();
+   (void)window.setActive(true);
+   window.close();
+
+   if (recording) recorder.save(recordPath, world.checksum());
+   if (replaying) reportReplay(replay, frameStats);
+
    return 0;  
-}
\ No newline at end of file
+}
+
+#else // ASHVALE_HEADLESS
+
+// Headless build: no window, GL context or audio device. Steps the simulation as fast as
+// it can with input from a seeded bot (or a replay), then prints a summary and a checksum
+// of the final state; the same seed and tick count always give the same checksum.
+//
+//   AshValeHeadless [--seed N] [--ticks N] [--map N] [--record file] [--trace file] [--counters file]
+//   AshValeHeadless --replay file [--trace file] [--counters file]
+int main(int argc, char* argv[])
+{
+   uint64_t seed = 1;
+   uint64_t ticks = 60 * 60; // One minute of play
+   int mapNumber = 1;
+   std::string recordPath;
+   std::string replayPath;
+   std::string tracePath;
+   for (int i = 1; i + 1 < argc; i += 2) {
+       std::string arg = argv[i];
+       if (arg == "--seed") parseNumberOption(arg, argv[i + 1], seed);
+       else if (arg == "--ticks") parseNumberOption(arg, argv[i + 1], ticks);
+       else if (arg == "--map") parseNumberOption(arg, argv[i + 1], mapNumber);
+       else if (arg == "--record") recordPath = argv[i + 1];
+       else if (arg == "--replay") replayPath = argv[i + 1];
+       else if (arg == "--trace") tracePath = argv[i + 1];
+       else if (arg == "--counters") counters().startDump(argv[i + 1], std::chrono::seconds(10));
+   }
+   bool recording = !recordPath.empty();
+   bool replaying = !replayPath.empty();
+   ReplayPlayer replay;
+   if (replaying) {
+       if (!replay.load(replayPath)) return 1;
+       seed = replay.getSeed();
+       mapNumber = replay.getStartMap();
+   }
+
+   assetPack().open(ASSET_PACK_FILE);
+
+   // Sprite rects drive animation and collision bounds; the pages are never uploaded
+   prepareSpriteAtlas(2048);
+   spriteAtlas.layoutWithoutTextures();
+   if (!textures.bind(spriteAtlas)) {
+       std::cerr << "Failed to load one or more sprite sheets!" << std::endl;
+   }
+   player.renderPlayer();
+
+   world.random.reseed(seed);
+   world.waitForStreaming = true;
+   if (!switchToMap(mapNumber)) {
+       std::cerr << "Failed to load map " << mapNumber << std::endl;
+       return 1;
+   }
+
+   RandomInputBot bot(seed);
+   ReplayRecorder recorder;
+   if (recording) recorder.begin(seed, mapNumber);
+   FrameStats stepStats;
+#if ASHVALE_PROFILING
+   // Pools, arenas and batches have grown to size by then; after it steps should not allocate
+   const uint64_t WARM_UP_STEPS = 600;
+   int64_t warmAllocations = 0;
+#endif
+   if (!tracePath.empty()) profiler().startCapture(tracePath, UINT64_MAX);
+   sf::Clock clock;
+   uint64_t steps = 0;
+   while (!world.quitRequested) {
+       InputFrame input;
+       if (replaying) {
+           if (replay.isFinished()) break;
+           input = replay.next();
+       } else {
+           if (world.tick >= ticks) break;
+           input = bot.next();
+
+           // Skip through the title and level cleared screens; the final screens end the run
+           if (world.screen == World::Screen::GameOver || world.screen == World::Screen::ToBeContinued) break;
+           input.confirm = world.screen != World::Screen::Playing;
+       }
+       if (recording) recorder.record(input);
+
+       sf::Clock stepClock;
+       world.step(input);
+       stepStats.add(stepClock.getElapsedTime());
+       PROFILE_FRAME();
+       COUNTERS_FRAME();
+       frameArena().reset();
+       ++steps;
+#if ASHVALE_PROFILING
+       if (steps == WARM_UP_STEPS) warmAllocations = heapAllocationCount.load();
+#endif
+   }
+   profiler().stopCapture();
+   sf::Time elapsed = clock.getElapsedTime();
+   logger().flush();
+
+   std::cout << "Headless run: seed " << seed << ", " << world.tick << " ticks in " << elapsed.asMilliseconds() << " ms ("
+       << (steps > 0 ? elapsed.asMicroseconds() / static_cast<int64_t>(steps) : 0) << " us/tick)" << std::endl;
+   std::cout << "Map " << mapManager.getCurrentMapNumber() << ", score " << player.score << ", health " << player.health
+       << ", enemies " << world.enemies.size() << std::endl;
+   std::cout << "Checksum " << std::hex << world.checksum() << std::dec << std::endl;
+   if (recording) recorder.save(recordPath, world.checksum());
+   if (replaying) reportReplay(replay, stepStats);
+   else stepStats.print("Steps");
+#if ASHVALE_PROFILING
+   profiler().printReport();
+   counters().printReport();
+   if (steps > WARM_UP_STEPS) {
+       std::cout << "Heap allocations after warm-up: " << heapAllocationCount.load() - warmAllocations << " in "
+           << steps - WARM_UP_STEPS << " steps (level loads allocate; steady play should not)" << std::endl;
+   }
+#endif
+   return 0;
+}
+
+#endif // ASHVALE_HEADLESS
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include "Animation.h"
+#include "TextureAtlas.h"
+
+// Image assets shared by the game and the offline tools
+
+const std::string forestTilesheet = "Assets/Map/Fantasy/forest_/forest_1.png";
+const std::string tundraTilesheet = "Assets/Map/Fantasy/tundra_/tundra_.png";
+
+// Level 2 is set in the tundra, every other level in the forest
+inline const std::string& tilesheetForMap(int mapNumber) {
+    return mapNumber == 2 ? tundraTilesheet : forestTilesheet;
+}
+
+// Goblins live in the tundra, slimes in the forest; used when a map has no wave file
+inline EnemyKind enemyKindForMap(int mapNumber) {
+    return mapNumber == 2 ? EnemyKind::Goblin : EnemyKind::Slime;
+}
+
+// Prebuilt atlas written by AtlasPacker; the game packs at startup when it is missing or stale
+const std::string SPRITE_ATLAS_TABLE = "Assets/Atlas/sprites.atlas";
+
+const char* const SPRITE_ATLAS_DIRECTORIES[] = {
+    "Assets/32 Free Weapon Icons/Icons",
+    "Assets/32_2 Free Weapon icons bonus/Icons",
+    "Assets/UI",
+};
+
+// Everything the game draws from the sprite atlas: tilesheets, animation sheets,
+// weapon icons and UI sheets
+inline void addSpriteAtlasSources(TextureAtlas& atlas) {
+    atlas.addFile(forestTilesheet);
+    atlas.addFile(tundraTilesheet);
+    for (const char* path : TEXTURE_PATHS) {
+        atlas.addFile(path);
+    }
+    for (const char* directory : SPRITE_ATLAS_DIRECTORIES) {
+        atlas.addDirectory(directory);
+    }
+}
+
+// Written by AssetPacker; the game falls back to the loose files under Assets when it is missing
+const std::string ASSET_PACK_FILE = "AshVale.pack";
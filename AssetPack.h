@@ -0,0 +1,375 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Audio.hpp>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include "MappedFile.h"
+#include "Compression.h"
+
+// Every asset in one file, so a cold start is one open plus sequential reads instead of
+// a filesystem lookup per asset. Little-endian:
+//   PackHeader
+//   PackEntry[entryCount]      sorted by id, for binary search
+//   names                      NUL-terminated asset paths, indexed by PackEntry::nameOffset
+//   entry data                 each entry 16-byte aligned, in the order they were packed
+// An asset's id is the FNV-1a hash of its path with forward slashes, e.g.
+// "Assets/Font/PIXBOB MINI LITE.ttf", so lookups never touch the string table.
+const uint32_t ASSET_PACK_MAGIC = 0x4B505641; // "AVPK"
+const uint16_t ASSET_PACK_VERSION = 1;
+
+enum class AssetType : uint8_t { Data, Texture, Sound, Font, Map };
+enum class AssetCompression : uint8_t { None, LZ };
+
+struct PackHeader {
+    uint32_t magic = ASSET_PACK_MAGIC;
+    uint16_t version = ASSET_PACK_VERSION;
+    uint16_t reserved = 0;
+    uint32_t entryCount = 0;
+    uint32_t namesSize = 0;     // Bytes of the name table
+};
+static_assert(sizeof(PackHeader) == 16, "PackHeader must match the file layout");
+
+struct PackEntry {
+    uint64_t id = 0;
+    uint64_t offset = 0;        // From the start of the file
+    uint32_t size = 0;          // Bytes stored in the pack
+    uint32_t rawSize = 0;       // Bytes once decompressed; equal to size when stored as is
+    uint32_t nameOffset = 0;
+    AssetType type = AssetType::Data;
+    AssetCompression compression = AssetCompression::None;
+    uint16_t reserved = 0;
+};
+static_assert(sizeof(PackEntry) == 32, "PackEntry must match the file layout");
+
+// "Assets\\Font\\a.ttf" and "./Assets/Font/a.ttf" both become "Assets/Font/a.ttf"
+inline std::string normalizeAssetPath(const std::string& path) {
+    std::string normalized = path;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0) normalized.erase(0, 2);
+    return normalized;
+}
+
+inline uint64_t assetId(const std::string& path) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : normalizeAssetPath(path)) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline AssetType assetTypeFromPath(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".png" || extension == ".jpg" || extension == ".bmp") return AssetType::Texture;
+    if (extension == ".wav" || extension == ".ogg" || extension == ".flac" || extension == ".mp3") return AssetType::Sound;
+    if (extension == ".ttf" || extension == ".otf") return AssetType::Font;
+    if (extension == ".dat") return AssetType::Map;
+    return AssetType::Data;
+}
+
+// Bytes of one asset; either a range of the mapped pack or a decompressed copy owned by it
+struct AssetData {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// Read-only view of a pack. The pack stays mapped for as long as it is open, so assets
+// that keep reading their memory (sf::Music, sf::Font) can point straight into it.
+class AssetPack {
+public:
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        if (!file_.open(path)) return false;
+
+        const uint8_t* base = file_.data();
+        size_t size = file_.size();
+        PackHeader header;
+        if (size < sizeof(header)) return fail(path, "truncated header");
+        std::memcpy(&header, base, sizeof(header));
+        if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION) return fail(path, "not an asset pack");
+
+        size_t namesStart = sizeof(header) + static_cast<size_t>(header.entryCount) * sizeof(PackEntry);
+        if (namesStart > size || header.namesSize > size - namesStart) return fail(path, "truncated index");
+
+        entries_.resize(header.entryCount);
+        std::memcpy(entries_.data(), base + sizeof(header), entries_.size() * sizeof(PackEntry));
+        names_ = reinterpret_cast<const char*>(base + namesStart);
+        namesSize_ = header.namesSize;
+        for (const PackEntry& entry : entries_) {
+            if (entry.offset > size || entry.size > size - entry.offset || entry.nameOffset >= namesSize_) {
+                return fail(path, "entry out of range");
+            }
+        }
+
+        // Everything in the pack is needed at startup; let the OS read it in sequentially
+        file_.willNeed();
+        std::cout << "Opened asset pack " << path << " (" << entries_.size() << " assets)" << std::endl;
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        decompressed_.clear();
+        entries_.clear();
+        names_ = nullptr;
+        namesSize_ = 0;
+        file_.close();
+    }
+
+    bool isOpen() const { return file_.isOpen(); }
+    size_t getEntryCount() const { return entries_.size(); }
+
+    const PackEntry* find(const std::string& path) const {
+        uint64_t id = assetId(path);
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), id,
+            [](const PackEntry& entry, uint64_t value) { return entry.id < value; });
+        return it != entries_.end() && it->id == id ? &*it : nullptr;
+    }
+
+    bool contains(const std::string& path) const { return find(path) != nullptr; }
+
+    // Empty if the asset is not in the pack. Compressed entries are decoded once and kept.
+    // Safe to call from several loader threads.
+    AssetData get(const std::string& path) {
+        const PackEntry* entry = find(path);
+        if (entry == nullptr) return AssetData();
+
+        const uint8_t* stored = file_.data() + entry->offset;
+        if (entry->compression == AssetCompression::None) return AssetData{ stored, entry->size };
+
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto cached = decompressed_.find(entry->id);
+        if (cached != decompressed_.end()) return AssetData{ cached->second.data(), cached->second.size() };
+
+        std::vector<uint8_t> raw(entry->rawSize);
+        if (!lz::decompress(stored, entry->size, raw.data(), raw.size())) {
+            std::cerr << "Corrupt asset in pack: " << path << std::endl;
+            return AssetData();
+        }
+        auto& inserted = decompressed_[entry->id] = std::move(raw);
+        return AssetData{ inserted.data(), inserted.size() };
+    }
+
+    // Paths of the assets directly inside a directory, optionally filtered by extension, sorted
+    std::vector<std::string> list(const std::string& directory, const std::string& extension = "") const {
+        std::string prefix = normalizeAssetPath(directory);
+        if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+        std::vector<std::string> paths;
+        for (const PackEntry& entry : entries_) {
+            std::string name = getName(entry);
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            if (name.find('/', prefix.size()) != std::string::npos) continue;
+            if (!extension.empty() && std::filesystem::path(name).extension() != extension) continue;
+            paths.push_back(name);
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::string getName(const PackEntry& entry) const {
+        const char* name = names_ + entry.nameOffset;
+        return std::string(name, strnlen(name, namesSize_ - entry.nameOffset));
+    }
+
+private:
+    bool fail(const std::string& path, const char* reason) {
+        std::cerr << "Failed to open asset pack " << path << ": " << reason << std::endl;
+        close();
+        return false;
+    }
+
+    MappedFile file_;
+    std::vector<PackEntry> entries_;
+    const char* names_ = nullptr;
+    uint32_t namesSize_ = 0;
+    std::mutex cacheMutex_;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> decompressed_;
+};
+
+// The game's pack; when it is not open every asset is read from its loose file
+inline AssetPack& assetPack() {
+    static AssetPack pack;
+    return pack;
+}
+
+// Loaders that take an asset from the pack when it is there, otherwise from disk.
+// Paths are the same either way.
+
+inline bool loadImageAsset(sf::Image& image, const std::string& path) {
+    if (AssetData asset = assetPack().get(path)) return image.loadFromMemory(asset.data, asset.size);
+    return image.loadFromFile(path);
+}
+
+inline bool loadTextureAsset(sf::Texture& texture, const std::string& path) {
+    if (AssetData asset = assetPack().get(path)) return texture.loadFromMemory(asset.data, asset.size);
+    return texture.loadFromFile(path);
+}
+
+inline bool loadSoundBufferAsset(sf::SoundBuffer& buffer, const std::string& path) {
+    if (AssetData asset = assetPack().get(path)) return buffer.loadFromMemory(asset.data, asset.size);
+    return buffer.loadFromFile(path);
+}
+
+// Fonts and music keep reading from their source, which the pack keeps mapped
+inline bool openFontAsset(sf::Font& font, const std::string& path) {
+    if (AssetData asset = assetPack().get(path)) return font.openFromMemory(asset.data, asset.size);
+    return font.openFromFile(path);
+}
+
+inline bool openMusicAsset(sf::Music& music, const std::string& path) {
+    if (AssetData asset = assetPack().get(path)) return music.openFromMemory(asset.data, asset.size);
+    return music.openFromFile(path);
+}
+
+inline bool readTextAsset(const std::string& path, std::string& text) {
+    if (AssetData asset = assetPack().get(path)) {
+        text.assign(reinterpret_cast<const char*>(asset.data), asset.size);
+        return true;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Builds a pack from loose files; used by the AssetPacker tool
+class AssetPackWriter {
+public:
+    // compress: store LZ-compressed when that actually saves space. Formats that are
+    // already compressed (png, ogg, ...) are always stored as is.
+    void addFile(const std::string& path, bool compress = false) {
+        std::string name = normalizeAssetPath(path);
+        for (const Source& source : sources_) {
+            if (source.name == name) return;
+        }
+        sources_.push_back(Source{ name, compress });
+    }
+
+    size_t getFileCount() const { return sources_.size(); }
+
+    bool save(const std::string& outputPath) const {
+        std::vector<PackEntry> entries;
+        std::vector<std::vector<uint8_t>> blobs;
+        std::string names;
+        for (const Source& source : sources_) {
+            std::ifstream file(source.name, std::ios::binary);
+            if (!file) {
+                std::cerr << "Failed to read asset: " << source.name << std::endl;
+                return false;
+            }
+            std::vector<uint8_t> raw((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+            PackEntry entry;
+            entry.id = assetId(source.name);
+            entry.type = assetTypeFromPath(source.name);
+            entry.rawSize = static_cast<uint32_t>(raw.size());
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            names += source.name;
+            names += '\0';
+
+            if (source.compress && isCompressible(source.name)) {
+                std::vector<uint8_t> packed = lz::compress(raw);
+                if (packed.size() < raw.size()) {
+                    entry.compression = AssetCompression::LZ;
+                    raw = std::move(packed);
+                }
+            }
+            entry.size = static_cast<uint32_t>(raw.size());
+
+            for (const PackEntry& other : entries) {
+                if (other.id == entry.id) {
+                    std::cerr << "Asset id collision: " << source.name << std::endl;
+                    return false;
+                }
+            }
+            entries.push_back(entry);
+            blobs.push_back(std::move(raw));
+        }
+
+        // Data goes in the order the files were added; the index is sorted by id
+        uint64_t offset = align(sizeof(PackHeader) + entries.size() * sizeof(PackEntry) + names.size());
+        for (PackEntry& entry : entries) {
+            entry.offset = offset;
+            offset = align(offset + entry.size);
+        }
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&entries](size_t a, size_t b) { return entries[a].id < entries[b].id; });
+
+        std::string tempPath = outputPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary);
+            if (!file) {
+                std::cerr << "Failed to write asset pack: " << outputPath << std::endl;
+                return false;
+            }
+            PackHeader header;
+            header.entryCount = static_cast<uint32_t>(entries.size());
+            header.namesSize = static_cast<uint32_t>(names.size());
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (size_t index : order) {
+                file.write(reinterpret_cast<const char*>(&entries[index]), sizeof(PackEntry));
+            }
+            file.write(names.data(), static_cast<std::streamsize>(names.size()));
+            for (size_t i = 0; i < entries.size(); ++i) {
+                pad(file, entries[i].offset);
+                file.write(reinterpret_cast<const char*>(blobs[i].data()), static_cast<std::streamsize>(blobs[i].size()));
+            }
+            if (!file) {
+                std::cerr << "Failed to write asset pack: " << outputPath << std::endl;
+                return false;
+            }
+        }
+
+        // Replace in one step so a running game that has the old pack mapped is unaffected
+        std::error_code error;
+        std::filesystem::rename(tempPath, outputPath, error);
+        if (error) {
+            std::filesystem::remove(outputPath, error);
+            std::filesystem::rename(tempPath, outputPath, error);
+        }
+        if (error) {
+            std::cerr << "Failed to replace asset pack " << outputPath << ": " << error.message() << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    struct Source {
+        std::string name;
+        bool compress = false;
+    };
+
+    static bool isCompressible(const std::string& path) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        return extension != ".png" && extension != ".jpg" && extension != ".ogg" && extension != ".mp3" && extension != ".flac";
+    }
+
+    static uint64_t align(uint64_t offset) { return (offset + 15) & ~uint64_t(15); }
+
+    static void pad(std::ofstream& file, uint64_t offset) {
+        while (static_cast<uint64_t>(file.tellp()) < offset) file.put('\0');
+    }
+
+    std::vector<Source> sources_;
+};
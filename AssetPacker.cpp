@@ -0,0 +1,85 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <filesystem>
+#include "AssetPack.h"
+#include "AssetManifest.h"
+
+// Offline asset pack builder. Run it after AtlasPacker so the atlas pages go in too.
+//
+//   AssetPacker                                       pack everything under Assets
+//   AssetPacker out.pack [--compress] a.png dir/ ...  pack the given files/directories
+//
+// Maps stay loose (the editor writes them), as do source files.
+
+bool isPackable(const std::filesystem::path& path) {
+    if (path.extension() == ".cpp" || path.extension() == ".pack" || path.extension() == ".tmp") return false;
+    for (const auto& part : path) {
+        if (part == "maps") return false;
+    }
+    return true;
+}
+
+void addPath(AssetPackWriter& writer, const std::string& source, bool compress) {
+    if (!std::filesystem::is_directory(source)) {
+        writer.addFile(source, compress);
+        return;
+    }
+
+    // Sorted so the pack is the same on every machine and a directory's files sit together
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(source)) {
+        if (entry.is_regular_file() && isPackable(entry.path())) {
+            files.push_back(entry.path().generic_string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto& file : files) {
+        writer.addFile(file, compress);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string output = ASSET_PACK_FILE;
+    bool compress = false;
+    std::vector<std::string> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--compress") {
+            compress = true;
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: AssetPacker [output.pack] [--compress] [file | directory]..." << std::endl;
+            return 0;
+        }
+        else if (output == ASSET_PACK_FILE && sources.empty() && std::filesystem::path(arg).extension() == ".pack") {
+            output = arg;
+        }
+        else {
+            sources.push_back(arg);
+        }
+    }
+
+    AssetPackWriter writer;
+    if (sources.empty()) {
+        // What the game reads first goes first, so startup reads the pack front to back
+        if (std::filesystem::exists(SPRITE_ATLAS_TABLE)) {
+            writer.addFile(SPRITE_ATLAS_TABLE, compress);
+            addPath(writer, std::filesystem::path(SPRITE_ATLAS_TABLE).parent_path().generic_string(), compress);
+        }
+        addPath(writer, "Assets", compress);
+    }
+    else {
+        for (const auto& source : sources) {
+            addPath(writer, source, compress);
+        }
+    }
+
+    if (!writer.save(output)) {
+        return 1;
+    }
+    std::cout << "Packed " << writer.getFileCount() << " assets: " << output << std::endl;
+    return 0;
+}
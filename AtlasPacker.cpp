@@ -0,0 +1,73 @@
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <charconv>
+#include "TextureAtlas.h"
+#include "AssetManifest.h"
+
+// Offline atlas builder. Packs images into atlas pages and writes them with a lookup
+// table the game loads at startup instead of decoding every source PNG.
+//
+//   AtlasPacker                                   pack the game's sprite atlas
+//   AtlasPacker out.atlas [--page-size N] a.png dir/ ...   pack the given files/directories
+//   --png                                         write PNG pages instead of pre-decoded ones
+
+int main(int argc, char* argv[]) {
+    std::string output = SPRITE_ATLAS_TABLE;
+    unsigned int pageSize = 2048;
+    bool preDecoded = true;
+    std::vector<std::string> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--page-size" && i + 1 < argc) {
+            std::string value = argv[++i];
+            unsigned int parsed = 0;
+            auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if (error != std::errc() || end != value.data() + value.size() || parsed == 0) {
+                std::cerr << "Ignoring --page-size " << value << ": expected a positive number, keeping " << pageSize << std::endl;
+            } else {
+                pageSize = parsed;
+            }
+        }
+        else if (arg == "--png") {
+            preDecoded = false;
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: AtlasPacker [output.atlas] [--page-size N] [--png] [image.png | directory]..." << std::endl;
+            return 0;
+        }
+        else if (output == SPRITE_ATLAS_TABLE && sources.empty() && std::filesystem::path(arg).extension() == ".atlas") {
+            output = arg;
+        }
+        else {
+            sources.push_back(arg);
+        }
+    }
+
+    TextureAtlas atlas;
+    if (sources.empty()) {
+        addSpriteAtlasSources(atlas);
+    }
+    else {
+        for (const auto& source : sources) {
+            if (std::filesystem::is_directory(source)) {
+                atlas.addDirectory(source);
+            }
+            else {
+                atlas.addFile(source);
+            }
+        }
+    }
+
+    bool packed = atlas.pack(pageSize);
+    if (!atlas.save(output, preDecoded)) {
+        return 1;
+    }
+
+    std::cout << "Packed " << atlas.getRegionCount() << " images into " << atlas.getPageCount()
+        << " page(s): " << output << std::endl;
+    return packed ? 0 : 1;
+}
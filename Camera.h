@@ -0,0 +1,33 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+
+// World camera: a fixed-size view centred on a target and clamped to the map, so it
+// never shows past the map edges. Maps smaller than the view are centred instead.
+class Camera {
+public:
+    explicit Camera(sf::Vector2f viewSize) : view_(viewSize / 2.f, viewSize) {}
+
+    void follow(sf::Vector2f target, sf::Vector2f worldSize) {
+        sf::Vector2f halfSize = view_.getSize() / 2.f;
+        sf::Vector2f center;
+        center.x = worldSize.x <= view_.getSize().x ? worldSize.x / 2.f : std::clamp(target.x, halfSize.x, worldSize.x - halfSize.x);
+        center.y = worldSize.y <= view_.getSize().y ? worldSize.y / 2.f : std::clamp(target.y, halfSize.y, worldSize.y - halfSize.y);
+        view_.setCenter(center);
+    }
+
+    const sf::View& getView() const { return view_; }
+
+    // World-space rectangle currently on screen
+    sf::FloatRect getVisibleArea() const {
+        return sf::FloatRect(view_.getCenter() - view_.getSize() / 2.f, view_.getSize());
+    }
+
+    bool isVisible(const sf::FloatRect& bounds) const {
+        return getVisibleArea().findIntersection(bounds).has_value();
+    }
+
+private:
+    sf::View view_;
+};
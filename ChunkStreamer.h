@@ -0,0 +1,375 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include "MapFormat.h"
+#include "Log.h"
+
+// Streams a chunked (version 3) map file. open() only reads the header and chunk index,
+// so start-up cost does not depend on the map size. Each frame update() is told what the
+// camera sees; chunks in a ring around it are read by a background I/O thread, and chunks
+// far away are evicted once more than the memory budget is resident.
+//
+// Chunk data is only touched on the main thread: the I/O thread hands finished chunks
+// back through a queue that update() drains. A chunk that is not resident yet is drawn
+// as nothing and is not passable.
+class ChunkStreamer {
+public:
+    static const size_t DEFAULT_MEMORY_BUDGET = 4 * 1024 * 1024; // Bytes of resident chunk data
+    static const int DEFAULT_RING_RADIUS = 1; // Chunks kept loaded around the visible ones
+
+    explicit ChunkStreamer(size_t memoryBudget = DEFAULT_MEMORY_BUDGET, int ringRadius = DEFAULT_RING_RADIUS)
+        : memoryBudget_(memoryBudget), ringRadius_(ringRadius) {}
+
+    ~ChunkStreamer() { close(); }
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    bool open(const std::string& filename) {
+        close();
+
+        std::ifstream file(filename, std::ios::binary);
+        MapFileHeader header;
+        ChunkTableHeader table;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.read(reinterpret_cast<char*>(&table), sizeof(table));
+        if (!file || header.magic != MAP_FILE_MAGIC || header.version != CHUNKED_MAP_FILE_VERSION ||
+            !header.hasValidSize() || table.chunkSize == 0 || table.chunkSize > MAX_MAP_DIMENSION) {
+            LOG_ERROR(LogCategory::Map, "Not a chunked map file: {}", filename);
+            return false;
+        }
+
+        width_ = static_cast<int>(header.width);
+        height_ = static_cast<int>(header.height);
+        chunkSize_ = static_cast<int>(table.chunkSize);
+        chunksX_ = (width_ + chunkSize_ - 1) / chunkSize_;
+        chunksY_ = (height_ + chunkSize_ - 1) / chunkSize_;
+        if (table.chunkCount != static_cast<uint32_t>(chunksX_ * chunksY_)) {
+            LOG_ERROR(LogCategory::Map, "Chunk index does not match the map size: {}", filename);
+            return false;
+        }
+
+        index_.resize(table.chunkCount);
+        file.read(reinterpret_cast<char*>(index_.data()), index_.size() * sizeof(ChunkIndexEntry));
+        if (!file) {
+            LOG_ERROR(LogCategory::Map, "Chunk index is truncated: {}", filename);
+            index_.clear();
+            return false;
+        }
+
+        filename_ = filename;
+        chunks_.clear();
+        chunks_.resize(index_.size());
+        states_.assign(index_.size(), ChunkState::Unloaded);
+        residentCount_ = 0;
+        ring_ = sf::IntRect();
+        maxResidentChunks_ = std::max<size_t>(1, memoryBudget_ / chunkDataSize(chunkSize_));
+        budgetWarningShown_ = false;
+
+        stopping_ = false;
+        ioThread_ = std::thread(&ChunkStreamer::ioThreadMain, this);
+        return true;
+    }
+
+    void close() {
+        if (ioThread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+                requests_.clear();
+            }
+            wake_.notify_all();
+            ioThread_.join();
+        }
+        completed_.clear();
+        inFlight_ = 0;
+        chunks_.clear();
+        states_.clear();
+        index_.clear();
+        residentCount_ = 0;
+        width_ = height_ = 0;
+    }
+
+    bool isOpen() const { return ioThread_.joinable(); }
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
+
+    sf::Vector2f getPixelSize() const {
+        return sf::Vector2f(static_cast<float>(width_ * SCALED_TILE_SIZE), static_cast<float>(height_ * SCALED_TILE_SIZE));
+    }
+
+    // Call once per frame with the camera's visible area (world pixels)
+    void update(const sf::FloatRect& focusArea) {
+        if (!isOpen()) return;
+
+        collectCompleted();
+
+        sf::IntRect ring = ringAround(focusArea);
+        if (ring != ring_) {
+            ring_ = ring;
+            requestRing();
+        }
+
+        evictOverBudget();
+    }
+
+    // Blocks until every requested chunk has arrived; used when a level starts so the
+    // player and the first enemies have ground under them. Bounded by the ring size.
+    void waitForRing() {
+        if (!isOpen()) return;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            loaded_.wait(lock, [this] { return requests_.empty() && inFlight_ == 0; });
+        }
+        collectCompleted();
+        evictOverBudget();
+    }
+
+    bool isTilePassable(int x, int y) const {
+        if (x < 0 || x >= width_ || y < 0 || y >= height_) return false;
+        const Chunk* chunk = chunks_[chunkIndex(x / chunkSize_, y / chunkSize_)].get();
+        if (chunk == nullptr) return false; // Not streamed in yet
+        return chunk->passable[localIndex(x % chunkSize_, y % chunkSize_)] != 0;
+    }
+
+    // Queue the resident tiles inside visibleArea (world pixels)
+    void draw(SpriteBatch& batch, const AtlasRegion& tilesheet, const sf::FloatRect& visibleArea) const {
+        if (!tilesheet.isValid() || !isOpen()) return;
+
+        sf::IntRect tiles = visibleTileRange(visibleArea, width_, height_);
+        if (tiles.size.x == 0 || tiles.size.y == 0) return;
+
+        int firstChunkX = tiles.position.x / chunkSize_;
+        int firstChunkY = tiles.position.y / chunkSize_;
+        int lastChunkX = (tiles.position.x + tiles.size.x - 1) / chunkSize_;
+        int lastChunkY = (tiles.position.y + tiles.size.y - 1) / chunkSize_;
+
+        for (int chunkY = firstChunkY; chunkY <= lastChunkY; ++chunkY) {
+            for (int chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX) {
+                const Chunk* chunk = chunks_[chunkIndex(chunkX, chunkY)].get();
+                if (chunk == nullptr) continue;
+
+                // Part of the visible tile range inside this chunk, in chunk-local tiles
+                sf::Vector2i origin(chunkX * chunkSize_, chunkY * chunkSize_);
+                int firstX = std::max(tiles.position.x, origin.x) - origin.x;
+                int firstY = std::max(tiles.position.y, origin.y) - origin.y;
+                int lastX = std::min(tiles.position.x + tiles.size.x, origin.x + chunkSize_) - origin.x;
+                int lastY = std::min(tiles.position.y + tiles.size.y, origin.y + chunkSize_) - origin.y;
+
+                TileGridView view{ chunk->tiles.data(), chunk->passable.data(), chunkSize_ };
+                view.draw(batch, tilesheet, sf::IntRect({ firstX, firstY }, { lastX - firstX, lastY - firstY }), origin);
+            }
+        }
+    }
+
+    // World-pixel area of the chunks currently kept around the camera
+    sf::FloatRect getStreamedArea() const {
+        float chunkPixels = static_cast<float>(chunkSize_ * SCALED_TILE_SIZE);
+        sf::FloatRect area(sf::Vector2f(ring_.position) * chunkPixels, sf::Vector2f(ring_.size) * chunkPixels);
+        sf::Vector2f mapSize = getPixelSize();
+        area.size.x = std::min(area.size.x, mapSize.x - area.position.x);
+        area.size.y = std::min(area.size.y, mapSize.y - area.position.y);
+        return area;
+    }
+
+    size_t getResidentChunkCount() const { return residentCount_; }
+    size_t getChunkCount() const { return chunks_.size(); }
+
+private:
+    struct Chunk {
+        std::vector<TileRecord> tiles;
+        std::vector<uint8_t> passable;
+    };
+
+    // Queued: waiting in requests_. InFlight: taken by the I/O thread, not collected yet.
+    enum class ChunkState : uint8_t { Unloaded, Queued, InFlight, Resident, Failed };
+
+    size_t chunkIndex(int chunkX, int chunkY) const { return static_cast<size_t>(chunkY) * chunksX_ + chunkX; }
+    size_t localIndex(int x, int y) const { return static_cast<size_t>(y) * chunkSize_ + x; }
+
+    // Chunks overlapping the area, grown by the ring radius and clamped to the map
+    sf::IntRect ringAround(const sf::FloatRect& area) const {
+        float chunkPixels = static_cast<float>(chunkSize_ * SCALED_TILE_SIZE);
+        int firstX = static_cast<int>(std::floor(area.position.x / chunkPixels)) - ringRadius_;
+        int firstY = static_cast<int>(std::floor(area.position.y / chunkPixels)) - ringRadius_;
+        int lastX = static_cast<int>(std::floor((area.position.x + area.size.x) / chunkPixels)) + ringRadius_;
+        int lastY = static_cast<int>(std::floor((area.position.y + area.size.y) / chunkPixels)) + ringRadius_;
+        firstX = std::clamp(firstX, 0, chunksX_ - 1);
+        firstY = std::clamp(firstY, 0, chunksY_ - 1);
+        lastX = std::clamp(lastX, 0, chunksX_ - 1);
+        lastY = std::clamp(lastY, 0, chunksY_ - 1);
+        return sf::IntRect({ firstX, firstY }, { lastX - firstX + 1, lastY - firstY + 1 });
+    }
+
+    bool isInRing(size_t index) const {
+        return ring_.contains(sf::Vector2i(static_cast<int>(index % chunksX_), static_cast<int>(index / chunksX_)));
+    }
+
+    // Squared distance in chunks from the ring's centre
+    int distanceFromRing(size_t index) const {
+        int dx = 2 * static_cast<int>(index % chunksX_) - (2 * ring_.position.x + ring_.size.x - 1);
+        int dy = 2 * static_cast<int>(index / chunksX_) - (2 * ring_.position.y + ring_.size.y - 1);
+        return dx * dx + dy * dy;
+    }
+
+    // Replace the request queue with the ring's missing chunks, nearest first. Chunks
+    // already being read are left alone, so none is read twice.
+    void requestRing() {
+        std::vector<size_t> wanted;
+        {
+            // The I/O thread marks chunks InFlight under the lock
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int y = ring_.position.y; y < ring_.position.y + ring_.size.y; ++y) {
+                for (int x = ring_.position.x; x < ring_.position.x + ring_.size.x; ++x) {
+                    size_t index = chunkIndex(x, y);
+                    if (states_[index] == ChunkState::Unloaded || states_[index] == ChunkState::Queued) {
+                        wanted.push_back(index);
+                    }
+                }
+            }
+            std::sort(wanted.begin(), wanted.end(), [this](size_t a, size_t b) {
+                return distanceFromRing(a) < distanceFromRing(b);
+            });
+
+            // Queued chunks that left the ring are dropped before the I/O thread gets to them
+            for (size_t index : requests_) {
+                if (!isInRing(index)) states_[index] = ChunkState::Unloaded;
+            }
+            requests_.assign(wanted.begin(), wanted.end());
+            for (size_t index : wanted) {
+                states_[index] = ChunkState::Queued;
+            }
+        }
+        wake_.notify_one();
+    }
+
+    void collectCompleted() {
+        std::vector<std::pair<size_t, std::unique_ptr<Chunk>>> completed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            completed.swap(completed_);
+        }
+        for (auto& [index, chunk] : completed) {
+            if (!chunk) {
+                states_[index] = ChunkState::Failed; // Stays blocked
+                continue;
+            }
+            if (!chunks_[index]) ++residentCount_;
+            chunks_[index] = std::move(chunk);
+            states_[index] = ChunkState::Resident;
+        }
+    }
+
+    // Drop the resident chunks farthest from the camera until back under budget;
+    // chunks in the ring are never evicted
+    void evictOverBudget() {
+        while (residentCount_ > maxResidentChunks_) {
+            size_t farthest = chunks_.size();
+            int farthestDistance = -1;
+            for (size_t i = 0; i < chunks_.size(); ++i) {
+                if (!chunks_[i] || isInRing(i)) continue;
+                int distance = distanceFromRing(i);
+                if (distance > farthestDistance) {
+                    farthestDistance = distance;
+                    farthest = i;
+                }
+            }
+            if (farthest == chunks_.size()) {
+                if (!budgetWarningShown_) {
+                    LOG_WARNING(LogCategory::Map, "Visible chunks exceed the streaming memory budget");
+                    budgetWarningShown_ = true;
+                }
+                return;
+            }
+            chunks_[farthest].reset();
+            states_[farthest] = ChunkState::Unloaded;
+            --residentCount_;
+        }
+    }
+
+    void ioThreadMain() {
+        std::ifstream file(filename_, std::ios::binary);
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+                if (stopping_) return;
+                index = requests_.front();
+                requests_.pop_front();
+                states_[index] = ChunkState::InFlight;
+                ++inFlight_;
+            }
+
+            std::unique_ptr<Chunk> chunk = readChunk(file, index_[index]);
+            if (!chunk) {
+                LOG_ERROR(LogCategory::Map, "Failed to read map chunk {} from {}", index, filename_);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                completed_.emplace_back(index, std::move(chunk));
+                --inFlight_;
+            }
+            loaded_.notify_all();
+        }
+    }
+
+    // Runs on the I/O thread
+    std::unique_ptr<Chunk> readChunk(std::ifstream& file, const ChunkIndexEntry& entry) const {
+        size_t tileCount = static_cast<size_t>(chunkSize_) * chunkSize_;
+        auto chunk = std::make_unique<Chunk>();
+        chunk->tiles.assign(tileCount, TileRecord());
+        chunk->passable.assign(tileCount, 1);
+        if (entry.size == 0) return chunk; // Empty chunk
+
+        if (entry.size != chunkDataSize(chunkSize_)) return nullptr;
+        file.clear();
+        file.seekg(static_cast<std::streamoff>(entry.offset));
+        file.read(reinterpret_cast<char*>(chunk->tiles.data()), tileCount * sizeof(TileRecord));
+        file.read(reinterpret_cast<char*>(chunk->passable.data()), tileCount);
+        if (!file) return nullptr;
+        return chunk;
+    }
+
+    // Map layout, fixed after open()
+    std::string filename_;
+    int width_ = 0;
+    int height_ = 0;
+    int chunkSize_ = DEFAULT_CHUNK_SIZE;
+    int chunksX_ = 0;
+    int chunksY_ = 0;
+    std::vector<ChunkIndexEntry> index_;
+
+    // Main thread only (states_ is also read and written under mutex_ while requesting,
+    // and the I/O thread marks a chunk InFlight under it)
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::vector<ChunkState> states_;
+    size_t residentCount_ = 0;
+    size_t memoryBudget_;
+    size_t maxResidentChunks_ = 1;
+    int ringRadius_;
+    sf::IntRect ring_;
+    bool budgetWarningShown_ = false;
+
+    // Shared with the I/O thread
+    std::thread ioThread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable loaded_;
+    std::deque<size_t> requests_;
+    std::vector<std::pair<size_t, std::unique_ptr<Chunk>>> completed_;
+    size_t inFlight_ = 0;
+    bool stopping_ = false;
+};
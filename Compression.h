@@ -0,0 +1,144 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Small LZ77 block codec in the style of LZ4: fast to decode, modest ratio. Used for
+// asset pack entries and pre-decoded textures, where decode speed matters far more
+// than size.
+//
+// A block is a series of sequences:
+//   token        high 4 bits literal length, low 4 bits match length - MIN_MATCH
+//   [255...]     extra literal length bytes when the nibble is 15
+//   literals
+//   offset       2 bytes little-endian, distance back into the output (1..65535)
+//   [255...]     extra match length bytes when the nibble is 15
+// The last sequence has literals only (no offset).
+namespace lz {
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 14;
+
+namespace detail {
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+inline void writeLength(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+inline void writeSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literalLength,
+    size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+    uint8_t token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (matchLength >= MIN_MATCH) token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+    out.push_back(token);
+    if (literalLength >= 15) writeLength(out, literalLength - 15);
+    out.insert(out.end(), literals, literals + literalLength);
+    if (matchLength >= MIN_MATCH) {
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if (matchCode >= 15) writeLength(out, matchCode - 15);
+    }
+}
+
+// Reads an extended length; false if it runs past the end of the input
+inline bool readLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in >= end) return false;
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace detail
+
+inline std::vector<uint8_t> compress(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+
+    std::vector<uint32_t> table(size_t(1) << HASH_BITS, 0); // Position + 1 of the last sequence with this hash
+    size_t anchor = 0; // Start of pending literals
+    size_t position = 0;
+    while (size >= MIN_MATCH && position + MIN_MATCH <= size) {
+        uint32_t sequence = detail::read32(data + position);
+        uint32_t& slot = table[detail::hash(sequence)];
+        size_t candidate = slot;
+        slot = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || detail::read32(data + candidate - 1) != sequence) {
+            ++position;
+            continue;
+        }
+
+        size_t match = candidate - 1;
+        size_t length = MIN_MATCH;
+        while (position + length < size && data[match + length] == data[position + length]) {
+            ++length;
+        }
+
+        detail::writeSequence(out, data + anchor, position - anchor, position - match, length);
+        position += length;
+        anchor = position;
+    }
+
+    detail::writeSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+inline std::vector<uint8_t> compress(const std::vector<uint8_t>& data) {
+    return compress(data.data(), data.size());
+}
+
+// Decodes into exactly outSize bytes; false on malformed input
+inline bool decompress(const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize) {
+    const uint8_t* end = in + inSize;
+    size_t written = 0;
+    while (in < end) {
+        uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !detail::readLength(in, end, literalLength)) return false;
+        if (literalLength > static_cast<size_t>(end - in) || literalLength > outSize - written) return false;
+        if (literalLength > 0) std::memcpy(out + written, in, literalLength);
+        in += literalLength;
+        written += literalLength;
+
+        if (in == end) break; // Last sequence
+
+        if (end - in < 2) return false;
+        size_t offset = static_cast<size_t>(in[0]) | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !detail::readLength(in, end, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if (offset == 0 || offset > written || matchLength > outSize - written) return false;
+
+        // Byte by byte: matches may overlap their own output
+        const uint8_t* source = out + written - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            out[written + i] = source[i];
+        }
+        written += matchLength;
+    }
+    return written == outSize;
+}
+
+} // namespace lz
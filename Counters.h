@@ -0,0 +1,216 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include "Profiler.h"
+
+// Named counters bumped from hot paths: COUNTER_ADD("A* nodes expanded", 1) for things
+// counted per frame, COUNTER_SET("enemies active", n) for levels. Once a frame
+// COUNTERS_FRAME() latches the frame's values for the F5 overlay and, every few seconds
+// while a dump is open, appends them to a JSON lines file for long unattended sessions.
+// Like the profiler zones they compile out with ASHVALE_PROFILING=0.
+
+// Bumped by the operator new replacement in AshVale.cpp
+inline std::atomic<int64_t> heapAllocationCount{ 0 };
+inline std::atomic<int64_t> heapAllocationBytes{ 0 };
+
+class Counter {
+public:
+    enum class Kind {
+        PerFrame,   // Reset every frame; reports the frame's total
+        Gauge,      // Keeps its value until set again
+    };
+
+    Counter(const std::string& name, Kind kind) : name_(name), kind_(kind) {}
+
+    // Any thread
+    void add(int64_t amount) { value_.fetch_add(amount, std::memory_order_relaxed); }
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+    const std::string& getName() const { return name_; }
+    Kind getKind() const { return kind_; }
+    int64_t getLast() const { return last_; }   // Last frame's total, or the gauge value
+
+private:
+    friend class CounterRegistry;
+
+    std::string name_;
+    Kind kind_;
+    std::atomic<int64_t> value_{ 0 };
+    int64_t last_ = 0;
+    int64_t intervalTotal_ = 0;   // Since the last dump
+    int64_t intervalMax_ = 0;
+};
+
+class CounterRegistry {
+public:
+    CounterRegistry()
+        : heapAllocations_(get("heap allocs", Counter::Kind::PerFrame)),
+        heapBytes_(get("heap bytes", Counter::Kind::PerFrame)) {
+    }
+
+    ~CounterRegistry() {
+        if (dumpFile_.is_open() && intervalFrames_ > 0) writeDump();
+    }
+
+    // The counter with this name, created on first use; the reference stays valid
+    Counter& get(const std::string& name, Counter::Kind kind) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Counter& counter : counters_) {
+            if (counter.name_ == name) return counter;
+        }
+        counters_.emplace_back(name, kind);
+        return counters_.back();
+    }
+
+    // Once per frame, after everything that counts has run
+    void endFrame() {
+        int64_t allocations = heapAllocationCount.load(std::memory_order_relaxed);
+        int64_t bytes = heapAllocationBytes.load(std::memory_order_relaxed);
+        heapAllocations_.add(allocations - lastHeapAllocations_);
+        heapBytes_.add(bytes - lastHeapBytes_);
+        lastHeapAllocations_ = allocations;
+        lastHeapBytes_ = bytes;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Counter& counter : counters_) {
+                counter.last_ = counter.kind_ == Counter::Kind::PerFrame
+                    ? counter.value_.exchange(0, std::memory_order_relaxed)
+                    : counter.value_.load(std::memory_order_relaxed);
+                counter.intervalTotal_ += counter.last_;
+                counter.intervalMax_ = std::max(counter.intervalMax_, counter.last_);
+            }
+        }
+        ++frameCount_;
+        ++intervalFrames_;
+
+        if (dumpFile_.is_open() && std::chrono::steady_clock::now() - lastDump_ >= dumpInterval_) writeDump();
+    }
+
+    // Appends a line per interval to path: {"time":s,"frame":n,"frames":n,"counters":{name:{"avg","max","last"}}}
+    bool startDump(const std::string& path, std::chrono::seconds interval) {
+        dumpFile_.open(path, std::ios::app);
+        if (!dumpFile_) {
+            std::cerr << "Failed to open counter dump: " << path << std::endl;
+            return false;
+        }
+        dumpInterval_ = interval;
+        dumpStart_ = lastDump_ = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        resetInterval();
+        return true;
+    }
+
+    void printReport() const {
+        std::cout << "Counters (last frame):" << std::endl;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Counter& counter : counters_) {
+            std::cout << "  " << counter.name_ << ": " << counter.last_ << std::endl;
+        }
+    }
+
+    // Counter table in screen space; the text is only rebuilt a few times a second
+    void drawOverlay(sf::RenderTarget& target, const sf::Font& font, sf::Vector2f position) {
+        if (!overlayText_ || overlayFont_ != &font) {
+            overlayFont_ = &font;
+            overlayText_.emplace(font, "", 14);
+            overlayText_->setFillColor(sf::Color::White);
+            overlayUpdatedFrame_ = 0;
+        }
+        if (frameCount_ - overlayUpdatedFrame_ >= 15 || overlayUpdatedFrame_ == 0) {
+            overlayUpdatedFrame_ = frameCount_;
+            char line[128];
+            std::string text;
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const Counter& counter : counters_) {
+                std::snprintf(line, sizeof(line), "%-20.20s %10lld\n", counter.name_.c_str(), static_cast<long long>(counter.last_));
+                text += line;
+            }
+            overlayText_->setString(text);
+        }
+        overlayText_->setPosition(position);
+        sf::FloatRect bounds = overlayText_->getGlobalBounds();
+        overlayBackground_.setPosition(bounds.position - sf::Vector2f(4.f, 4.f));
+        overlayBackground_.setSize(bounds.size + sf::Vector2f(8.f, 8.f));
+        overlayBackground_.setFillColor(sf::Color(0, 0, 0, 160));
+        target.draw(overlayBackground_);
+        target.draw(*overlayText_);
+    }
+
+private:
+    void writeDump() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - dumpStart_).count();
+        dumpFile_ << "{\"time\":" << seconds << ",\"frame\":" << frameCount_ << ",\"frames\":" << intervalFrames_ << ",\"counters\":{";
+        bool first = true;
+        for (const Counter& counter : counters_) {
+            if (!first) dumpFile_ << ",";
+            first = false;
+            double average = intervalFrames_ > 0 ? static_cast<double>(counter.intervalTotal_) / intervalFrames_ : 0.0;
+            dumpFile_ << "\"" << counter.name_ << "\":{\"avg\":" << average << ",\"max\":" << counter.intervalMax_
+                << ",\"last\":" << counter.last_ << "}";
+        }
+        // Flushed so a crash or power cut loses at most one interval
+        dumpFile_ << "}}" << std::endl;
+        lastDump_ = now;
+        resetInterval();
+    }
+
+    // Caller holds mutex_
+    void resetInterval() {
+        for (Counter& counter : counters_) {
+            counter.intervalTotal_ = 0;
+            counter.intervalMax_ = 0;
+        }
+        intervalFrames_ = 0;
+    }
+
+    // Guards counters_: get() can add one on any thread while the render thread walks
+    // them for the overlay, the dump or the report. Values themselves are atomic.
+    mutable std::mutex mutex_;
+    std::deque<Counter> counters_;  // deque: counters keep their address as more are added
+    Counter& heapAllocations_;
+    Counter& heapBytes_;
+    int64_t lastHeapAllocations_ = 0;
+    int64_t lastHeapBytes_ = 0;
+    uint64_t frameCount_ = 0;
+    uint64_t intervalFrames_ = 0;
+
+    std::ofstream dumpFile_;
+    std::chrono::seconds dumpInterval_{ 10 };
+    std::chrono::steady_clock::time_point dumpStart_;
+    std::chrono::steady_clock::time_point lastDump_;
+
+    const sf::Font* overlayFont_ = nullptr;
+    std::optional<sf::Text> overlayText_;
+    sf::RectangleShape overlayBackground_;
+    uint64_t overlayUpdatedFrame_ = 0;
+};
+
+inline CounterRegistry& counters() {
+    static CounterRegistry instance;
+    return instance;
+}
+
+#if ASHVALE_PROFILING
+// The counter is looked up once per call site
+#define COUNTER_ADD(name, amount) do { static Counter& counter_ = counters().get(name, Counter::Kind::PerFrame); counter_.add(static_cast<int64_t>(amount)); } while (0)
+#define COUNTER_SET(name, value) do { static Counter& counter_ = counters().get(name, Counter::Kind::Gauge); counter_.set(static_cast<int64_t>(value)); } while (0)
+#define COUNTERS_FRAME() counters().endFrame()
+#else
+#define COUNTER_ADD(name, amount) ((void)0)
+#define COUNTER_SET(name, value) ((void)0)
+#define COUNTERS_FRAME() ((void)0)
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "Counters.h"
+
+// A sprite to sort: its depth as an order-preserving integer and whatever index the
+// caller needs to find the sprite again
+struct DepthItem {
+    uint32_t key;
+    uint32_t index;
+};
+
+// Float to unsigned with the same order, negatives included: flip every bit of a
+// negative number, only the sign bit of a positive one
+inline uint32_t depthKey(float y) {
+    y += 0.f;   // -0 becomes 0, so the two tie like they compare
+    uint32_t bits;
+    std::memcpy(&bits, &y, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+// Back-to-front order for top-down sprites: whatever stands lower on screen (larger feet
+// y) is in front. Items are sorted with a stable LSD radix sort, a byte per pass, over
+// compact (key, index) pairs; all four histograms come from one read of the keys and a
+// pass whose byte is the same for every item is skipped. Equal keys keep the order they
+// were added in. Buffers keep their capacity between frames.
+class DepthSorter {
+public:
+    void clear() { items_.clear(); }
+
+    void add(float feetY, uint32_t index) { items_.push_back({ depthKey(feetY), index }); }
+
+    // Sorted back to front; valid until the next clear() or add()
+    const std::vector<DepthItem>& sort() {
+        const size_t count = items_.size();
+        COUNTER_ADD("sprites depth sorted", count);
+        if (count < 2) return items_;
+
+        uint32_t histograms[4][256] = {};
+        for (const DepthItem& item : items_) {
+            ++histograms[0][item.key & 0xFF];
+            ++histograms[1][(item.key >> 8) & 0xFF];
+            ++histograms[2][(item.key >> 16) & 0xFF];
+            ++histograms[3][item.key >> 24];
+        }
+
+        scratch_.resize(count);
+        for (int pass = 0; pass < 4; ++pass) {
+            uint32_t* histogram = histograms[pass];
+            const int shift = pass * 8;
+            if (histogram[(items_[0].key >> shift) & 0xFF] == count) continue;
+
+            // Counts to starting offsets
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket) {
+                uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (const DepthItem& item : items_) {
+                scratch_[histogram[(item.key >> shift) & 0xFF]++] = item;
+            }
+            std::swap(items_, scratch_);
+        }
+        return items_;
+    }
+
+private:
+    std::vector<DepthItem> items_;
+    std::vector<DepthItem> scratch_;
+};
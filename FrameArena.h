@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <new>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+
+// Bump allocator for scratch data that dies with the frame: search sets, temporary lists,
+// strings being built. Allocating is a pointer bump, freeing is a no-op, and reset()
+// rewinds it all at once at the end of the frame. Blocks are kept, so once the arena has
+// grown to a frame's needs it never touches the global heap again.
+//
+// Each thread has its own (frameArena()); nothing allocated from it may outlive the frame,
+// or the Scope it was allocated in.
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE) : blockSize_(blockSize) {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        while (true) {
+            if (block_ < blocks_.size()) {
+                Block& block = blocks_[block_];
+                size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+                if (start + size <= block.size) {
+                    offset_ = start + size;
+                    used_ += size;
+                    highWater_ = std::max(highWater_, used_);
+                    return block.memory.get() + start;
+                }
+                if (block_ + 1 < blocks_.size()) {
+                    ++block_;
+                    offset_ = 0;
+                    continue;
+                }
+            }
+            // Grow; only happens while the arena warms up to the largest frame
+            size_t blockBytes = std::max(blockSize_, size + alignment);
+            blocks_.push_back(Block{ std::unique_ptr<std::byte[]>(new std::byte[blockBytes]), blockBytes });
+            block_ = blocks_.size() - 1;
+            offset_ = 0;
+        }
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Once a frame, when no frame data is in use any more
+    void reset() {
+        block_ = 0;
+        offset_ = 0;
+        used_ = 0;
+    }
+
+    size_t getUsed() const { return used_; }
+    size_t getHighWater() const { return highWater_; }
+    size_t getCapacity() const {
+        size_t capacity = 0;
+        for (const Block& block : blocks_) capacity += block.size;
+        return capacity;
+    }
+
+    // Rewinds the arena, when it goes out of scope, to where it was when it began; for
+    // scratch use off the main thread, where there is no frame end to reset at
+    class Scope {
+    public:
+        explicit Scope(FrameArena& arena) : arena_(arena), block_(arena.block_), offset_(arena.offset_), used_(arena.used_) {}
+        ~Scope() {
+            arena_.block_ = block_;
+            arena_.offset_ = offset_;
+            arena_.used_ = used_;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        FrameArena& arena_;
+        size_t block_;
+        size_t offset_;
+        size_t used_;
+    };
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t block_ = 0;
+    size_t offset_ = 0;
+    size_t used_ = 0;
+    size_t highWater_ = 0;
+};
+
+inline FrameArena& frameArena() {
+    thread_local FrameArena arena;
+    return arena;
+}
+
+// Standard allocator over an arena (the calling thread's frame arena by default), so
+// containers can keep their scratch there: FrameVector<Node> open(FrameAllocator<Node>());
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() : arena_(&frameArena()) {}
+    explicit FrameAllocator(FrameArena& arena) : arena_(&arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) : arena_(other.getArena()) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    FrameArena* getArena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const { return arena_ == other.getArena(); }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>& other) const { return arena_ != other.getArena(); }
+
+private:
+    FrameArena* arena_;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+using FrameUnorderedMap = std::unordered_map<Key, Value, Hash, Equal, FrameAllocator<std::pair<const Key, Value>>>;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Triple buffer between the simulation (producer) and the render thread (consumer). The
+// producer fills back(), publish() swaps it with the pending slot; the consumer's
+// acquire() swaps the pending slot with the one it last drew. Neither side ever touches
+// a slot the other is using and the swaps take no lock: the only shared state is the
+// pending slot's index and a "fresh" bit in one atomic. The mutex and condition variable
+// are only for a side that has to sleep until the other has moved.
+//
+// If the producer publishes twice before the consumer comes back, the older packet is
+// simply replaced; waitUntilTaken() lets the producer stay at most one packet ahead
+// instead, so no frame is built only to be thrown away.
+template <typename T>
+class FrameHandoff {
+public:
+    // Producer: the packet being built
+    T& back() { return slots_[back_]; }
+
+    // Producer: hand back() over; back() is a different slot afterwards
+    void publish() {
+        uint32_t previous = pending_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+        back_ = previous & INDEX_MASK;
+        wakeOther();
+    }
+
+    // Producer: blocks until the consumer has picked up the last published packet
+    void waitUntilTaken() {
+        if (!(pending_.load(std::memory_order_acquire) & FRESH)) return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] {
+            return !(pending_.load(std::memory_order_acquire) & FRESH) || closed_.load(std::memory_order_acquire);
+        });
+    }
+
+    // Consumer: blocks until there is a packet it has not seen yet; nullptr once closed
+    T* acquire() {
+        if (!(pending_.load(std::memory_order_acquire) & FRESH)) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed_.wait(lock, [this] {
+                return (pending_.load(std::memory_order_acquire) & FRESH) || closed_.load(std::memory_order_acquire);
+            });
+        }
+        if (closed_.load(std::memory_order_acquire)) return nullptr;
+        front_ = pending_.exchange(front_, std::memory_order_acq_rel) & INDEX_MASK;
+        wakeOther();
+        return &slots_[front_];
+    }
+
+    // Producer: wakes the consumer for good
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        pending_.fetch_or(FRESH, std::memory_order_acq_rel);
+        wakeOther();
+    }
+
+private:
+    // Taking the lock between the state change and the notify means a side that checked
+    // the state under the lock is either already waiting or will see the change
+    void wakeOther() {
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        changed_.notify_all();
+    }
+
+    static constexpr uint32_t INDEX_MASK = 3;
+    static constexpr uint32_t FRESH = 4;
+
+    T slots_[3];
+    uint32_t back_ = 0;     // Producer only
+    uint32_t front_ = 2;    // Consumer only
+    alignas(64) std::atomic<uint32_t> pending_{ 1 };
+    std::atomic<bool> closed_{ false };
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
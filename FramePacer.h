@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+// Starts frames at a steady rate. setFramerateLimit sleeps for the whole remainder of the
+// frame, and a sleep can overshoot by a millisecond or more (several on a loaded Linux
+// box), so frame times wobble. Here the wait is split: sleep until shortly before the
+// deadline, then spin on the high resolution clock for the rest. The spin margin follows
+// the worst recent oversleep, so it stays small on a quiet machine.
+//
+// Deadlines advance by exactly one period, so the average rate is exact; a frame that
+// runs late starts the next period from now instead of rushing to catch up.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FramePacer(double framesPerSecond = 60.0) { setTargetRate(framesPerSecond); }
+
+    // 0 turns pacing off (uncapped, or vsync doing the waiting)
+    void setTargetRate(double framesPerSecond) {
+        targetRate_ = framesPerSecond;
+        period_ = framesPerSecond > 0.0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+            : Clock::duration::zero();
+        deadline_ = Clock::now() + period_;
+    }
+
+    double getTargetRate() const { return targetRate_; }
+
+    // Blocks until the next frame should start
+    void wait() {
+        if (period_ == Clock::duration::zero()) return;
+
+        Clock::time_point now = Clock::now();
+        if (now < deadline_) {
+            Clock::duration remaining = deadline_ - now;
+            if (remaining > margin_) {
+                Clock::time_point wakeUp = deadline_ - margin_;
+                sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(remaining - margin_).count()));
+                trackOversleep(Clock::now() - wakeUp);
+            }
+            while (Clock::now() < deadline_) {
+                std::this_thread::yield();
+            }
+            now = deadline_;
+        }
+
+        deadline_ += period_;
+        if (deadline_ <= now) {
+            deadline_ = now + period_;
+        }
+    }
+
+private:
+    static constexpr Clock::duration MIN_MARGIN = std::chrono::microseconds(250);
+    static constexpr Clock::duration MAX_MARGIN = std::chrono::milliseconds(4);
+
+    // The margin jumps up to cover a bad sleep and creeps back down (1/64 a frame)
+    void trackOversleep(Clock::duration oversleep) {
+        Clock::duration wanted = oversleep + MIN_MARGIN;
+        margin_ = std::max(margin_ - margin_ / 64, wanted);
+        margin_ = std::clamp(margin_, MIN_MARGIN, MAX_MARGIN);
+    }
+
+    double targetRate_ = 0.0;
+    Clock::duration period_{};
+    Clock::time_point deadline_;
+    Clock::duration margin_ = std::chrono::milliseconds(2);
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+// Frame (or step) times of a run, summarised as the numbers worth comparing between
+// builds: mean and the tail percentiles.
+class FrameStats {
+public:
+    void add(sf::Time frameTime) { samples_.push_back(frameTime.asMicroseconds()); }
+    void clear() { samples_.clear(); }
+    size_t getCount() const { return samples_.size(); }
+
+    // p in [0, 1]; nearest-rank
+    sf::Time percentile(float p) const {
+        if (samples_.empty()) return sf::Time::Zero;
+        std::vector<int64_t> sorted = samples_;
+        size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sf::microseconds(sorted[rank]);
+    }
+
+    sf::Time mean() const {
+        if (samples_.empty()) return sf::Time::Zero;
+        int64_t total = 0;
+        for (int64_t sample : samples_) total += sample;
+        return sf::microseconds(total / static_cast<int64_t>(samples_.size()));
+    }
+
+    sf::Time max() const {
+        if (samples_.empty()) return sf::Time::Zero;
+        return sf::microseconds(*std::max_element(samples_.begin(), samples_.end()));
+    }
+
+    void print(const std::string& label) const {
+        auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+        std::cout << label << ": " << samples_.size() << " frames, mean " << ms(mean()) << " ms, p50 " << ms(percentile(0.5f))
+            << " ms, p95 " << ms(percentile(0.95f)) << " ms, p99 " << ms(percentile(0.99f)) << " ms, max " << ms(max()) << " ms" << std::endl;
+    }
+
+private:
+    std::vector<int64_t> samples_; // Microseconds
+};
+
+// Frame times over the last WINDOW frames, for watching smoothness while the game runs.
+// Samples go into 0.1 ms buckets (the last one takes everything from 100 ms up), so
+// adding one and reading a percentile are both cheap however long it has been running;
+// percentiles are reported as the top of their bucket.
+class FrameTimeHistogram {
+public:
+    static constexpr size_t WINDOW = 600;               // 10 s at 60 fps
+    static constexpr int64_t BUCKET_MICROSECONDS = 100;
+    static constexpr size_t BUCKETS = 1000;
+
+    void add(sf::Time frameTime) {
+        int64_t sample = std::max<int64_t>(0, frameTime.asMicroseconds());
+        if (count_ == WINDOW) {
+            --buckets_[bucketOf(samples_[next_])];
+        } else {
+            ++count_;
+        }
+        samples_[next_] = sample;
+        next_ = (next_ + 1) % WINDOW;
+        ++buckets_[bucketOf(sample)];
+    }
+
+    size_t getCount() const { return count_; }
+
+    // p in [0, 1]
+    sf::Time percentile(float p) const {
+        if (count_ == 0) return sf::Time::Zero;
+        size_t rank = std::clamp<size_t>(static_cast<size_t>(std::ceil(p * count_)), 1, count_);
+        size_t seen = 0;
+        for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+            seen += buckets_[bucket];
+            if (seen >= rank) return sf::microseconds(static_cast<int64_t>(bucket + 1) * BUCKET_MICROSECONDS);
+        }
+        return max();
+    }
+
+    // Exact, unlike the percentiles
+    sf::Time max() const {
+        int64_t longest = 0;
+        for (size_t i = 0; i < count_; ++i) longest = std::max(longest, samples_[i]);
+        return sf::microseconds(longest);
+    }
+
+    // "p50 16.7  p95 17.1  p99 18.0  max 19.2 ms"
+    std::string summary() const {
+        auto ms = [](sf::Time time) { return time.asMicroseconds() / 1000.0; };
+        char text[96];
+        std::snprintf(text, sizeof(text), "p50 %.1f  p95 %.1f  p99 %.1f  max %.1f ms", ms(percentile(0.5f)), ms(percentile(0.95f)),
+            ms(percentile(0.99f)), ms(max()));
+        return text;
+    }
+
+private:
+    static size_t bucketOf(int64_t sample) {
+        return std::min(BUCKETS - 1, static_cast<size_t>(sample / BUCKET_MICROSECONDS));
+    }
+
+    std::array<int64_t, WINDOW> samples_{};
+    std::array<uint32_t, BUCKETS> buckets_{};
+    size_t count_ = 0;
+    size_t next_ = 0;
+};
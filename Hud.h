@@ -0,0 +1,106 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <string>
+#include "TextureAtlas.h"
+#include "Counters.h"
+#include "Log.h"
+
+// Score, level and health hearts in screen space. Each part keeps its geometry between
+// frames and is only rebuilt when its value changes: setString re-lays out every glyph
+// and the hearts used to be re-queued one transform at a time. On a frame where nothing
+// changed the HUD is its fixed number of draw calls and nothing else.
+class Hud {
+public:
+    // Hearts (one call, atlas page) + score + level
+    static constexpr int DRAW_CALL_BUDGET = 3;
+
+    void setup(const sf::Font& font, sf::Vector2u windowSize, const AtlasRegion& heartIcon) {
+        heartIcon_ = heartIcon;
+
+        scoreText_.emplace(font, "", 32);
+        scoreText_->setFillColor(sf::Color::Black);
+        scoreText_->setPosition(sf::Vector2f(windowSize.x - 200.f, 40.f));
+
+        levelText_.emplace(font, "", 32);
+        levelText_->setFillColor(sf::Color::Black);
+        levelText_->setPosition(sf::Vector2f(windowSize.x - 200.f, 70.f));
+
+        score_ = level_ = health_ = -1;
+        hearts_.setPrimitiveType(sf::PrimitiveType::Triangles);
+        hearts_.clear();
+    }
+
+    // Once a frame; rebuilds only what changed
+    void update(int score, int level, int health) {
+        if (score != score_) {
+            score_ = score;
+            scoreText_->setString("Score: " + std::to_string(score));
+            COUNTER_ADD("HUD rebuilds", 1);
+        }
+        if (level != level_) {
+            level_ = level;
+            levelText_->setString("Level: " + std::to_string(level));
+            COUNTER_ADD("HUD rebuilds", 1);
+        }
+        if (health != health_) {
+            health_ = health;
+            rebuildHearts();
+            COUNTER_ADD("HUD rebuilds", 1);
+        }
+    }
+
+    // In screen space (the default view)
+    void draw(sf::RenderTarget& target) {
+        int drawCalls = 0;
+        if (heartIcon_.isValid() && hearts_.getVertexCount() > 0) {
+            target.draw(hearts_, sf::RenderStates(heartIcon_.page));
+            ++drawCalls;
+        }
+        target.draw(*scoreText_);
+        target.draw(*levelText_);
+        drawCalls += 2;
+
+        COUNTER_ADD("draw calls", drawCalls);
+        COUNTER_ADD("HUD draw calls", drawCalls);
+        if (drawCalls > DRAW_CALL_BUDGET && !budgetWarningShown_) {
+            LOG_WARNING(LogCategory::Game, "HUD took {} draw calls, budget is {}", drawCalls, DRAW_CALL_BUDGET);
+            budgetWarningShown_ = true;
+        }
+    }
+
+private:
+    // One 24x24 heart per health point along the top left, all from the atlas page
+    void rebuildHearts() {
+        hearts_.clear();
+        if (!heartIcon_.isValid()) return;
+
+        sf::Vector2f texLeftTop(heartIcon_.rect.position);
+        sf::Vector2f texRightBottom = texLeftTop + sf::Vector2f(32.f, 32.f); // The heart is the first 32x32 cell
+        const float size = 32.f * 0.75f;
+        for (int i = 0; i < health_; ++i) {
+            sf::Vector2f leftTop(10.f + i * 30.f, 10.f);
+            sf::Vector2f rightBottom = leftTop + sf::Vector2f(size, size);
+            sf::Vertex topLeft{ leftTop, sf::Color::White, texLeftTop };
+            sf::Vertex topRight{ { rightBottom.x, leftTop.y }, sf::Color::White, { texRightBottom.x, texLeftTop.y } };
+            sf::Vertex bottomLeft{ { leftTop.x, rightBottom.y }, sf::Color::White, { texLeftTop.x, texRightBottom.y } };
+            sf::Vertex bottomRight{ rightBottom, sf::Color::White, texRightBottom };
+            hearts_.append(topLeft);
+            hearts_.append(topRight);
+            hearts_.append(bottomLeft);
+            hearts_.append(bottomLeft);
+            hearts_.append(topRight);
+            hearts_.append(bottomRight);
+        }
+    }
+
+    AtlasRegion heartIcon_;
+    std::optional<sf::Text> scoreText_;   // sf::Text needs a font to exist
+    std::optional<sf::Text> levelText_;
+    sf::VertexArray hearts_;
+    int score_ = -1;
+    int level_ = -1;
+    int health_ = -1;
+    bool budgetWarningShown_ = false;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include "Random.h"
+
+// Player input for one simulation tick. The game samples the keyboard and mouse into it;
+// headless runs inject it instead, so the simulation never polls devices itself.
+struct InputFrame {
+    enum Button : uint8_t {
+        Left = 1 << 0,
+        Right = 1 << 1,
+        Up = 1 << 2,
+        Down = 1 << 3,
+        Dash = 1 << 4,
+        Attack = 1 << 5,
+    };
+
+    uint8_t held = 0;       // Buttons down this tick
+    bool confirm = false;   // Space pressed this tick (start / continue / exit)
+    uint8_t mapKey = 0;     // Number key pressed this tick: map 1-10, 0 for none
+
+    bool isHeld(Button button) const { return (held & button) != 0; }
+    void press(Button button) { held |= button; }
+};
+
+// Stand-in player for headless runs: walks in a direction for a while, swings and dashes
+// now and then. Driven only by its seed, so a run can be repeated exactly.
+class RandomInputBot {
+public:
+    explicit RandomInputBot(uint64_t seed) : random_(seed, 0x5eed) {}
+
+    InputFrame next() {
+        if (ticksLeft_ == 0) {
+            // Any combination of directions, including none and opposing ones
+            direction_ = static_cast<uint8_t>(random_.below(16));
+            ticksLeft_ = random_.range(15, 90);
+        }
+        --ticksLeft_;
+
+        InputFrame frame;
+        frame.held = direction_;
+        if (random_.below(20) == 0) frame.press(InputFrame::Attack);
+        if (random_.below(120) == 0) frame.press(InputFrame::Dash);
+        return frame;
+    }
+
+private:
+    Random random_;
+    uint8_t direction_ = 0;
+    int ticksLeft_ = 0;
+};
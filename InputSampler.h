@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <chrono>
+#include <optional>
+#include "Input.h"
+
+// Keyboard and mouse state for the windowed game. The loop reads it as late as it can,
+// right before the ticks that use it, and the simulation may read it again just before
+// the player moves (World::resampleHeld).
+//
+// It also remembers when the oldest input not yet simulated was first seen, so the time
+// from input to the frame that shows it can be measured. SFML events carry no timestamp:
+// "seen" is when a press was polled or a held button was first read as down, so time the
+// event spent queued in the OS before that is not included.
+class InputSampler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Buttons held right now
+    uint8_t sampleHeld() {
+        uint8_t held = 0;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A)) held |= InputFrame::Left;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D)) held |= InputFrame::Right;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W)) held |= InputFrame::Up;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S)) held |= InputFrame::Down;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift)) held |= InputFrame::Dash;
+        if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) held |= InputFrame::Attack;
+
+        // A newly pressed button is new input
+        if (held & ~lastHeld_) notice();
+        lastHeld_ = held;
+        return held;
+    }
+
+    // A press arrived as an event
+    void notice() {
+        if (!seen_) seen_ = Clock::now();
+    }
+
+    // When the oldest input since the last call was seen, if there was any
+    std::optional<Clock::time_point> takeSeen() {
+        std::optional<Clock::time_point> seen = seen_;
+        seen_.reset();
+        return seen;
+    }
+
+private:
+    uint8_t lastHeld_ = 0;
+    std::optional<Clock::time_point> seen_;
+};
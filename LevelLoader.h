@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <future>
+#include <filesystem>
+#include "MapManager.h"
+#include "NavGrid.h"
+#include "AssetManifest.h"
+#include "ThreadPool.h"
+#include "Random.h"
+#include "SpawnTable.h"
+#include "WaveScheduler.h"
+#include "Log.h"
+
+// Everything needed to start a level, built without touching the window or GL
+struct PreparedLevel {
+    int mapNumber = 0;
+    std::string filename;
+    bool loaded = false;
+    bool streamed = false;      // Chunked maps are opened (cheaply) by MapManager on swap
+    TileMap map;
+    NavGrid nav;
+    std::string tilesheetPath;  // Already resident in the sprite atlas
+    WavePlan waves;
+    SpawnTable spawnTable;      // Empty for streamed maps until their chunks are in
+    std::vector<sf::Vector2f> spawnPoints;  // For the opening wave
+};
+
+// Builds the next level on a worker thread while a transition screen is up, so the
+// swap itself only moves the prepared data into place.
+class LevelLoader {
+public:
+    explicit LevelLoader(const MapManager& mapManager) : mapManager_(mapManager) {}
+
+    ~LevelLoader() {
+        if (pending_.valid()) pending_.wait();
+    }
+
+    LevelLoader(const LevelLoader&) = delete;
+    LevelLoader& operator=(const LevelLoader&) = delete;
+
+    // Start building a level in the background; seed drives the spawn rolls
+    void prefetch(int mapNumber, const SpawnRules& rules, unsigned int seed) {
+        if (pending_.valid() && pendingMap_ == mapNumber) return;
+        if (pending_.valid()) pending_.wait(); // One prefetch at a time
+
+        pendingMap_ = mapNumber;
+        pending_ = workerPool().submit([filename = mapManager_.getMapFilename(mapNumber), mapNumber, rules, seed] {
+            return build(filename, mapNumber, rules, seed);
+        });
+        LOG_INFO(LogCategory::Map, "Prefetching map {}", mapNumber);
+    }
+
+    // The prefetched level when it matches, otherwise it is built now on this thread
+    PreparedLevel take(int mapNumber, const SpawnRules& rules, unsigned int seed) {
+        if (pending_.valid()) {
+            [[maybe_unused]] bool ready = pending_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            PreparedLevel level = pending_.get();
+            if (level.mapNumber == mapNumber) {
+                LOG_INFO(LogCategory::Map, "Using prefetched map {}{}", mapNumber, ready ? "" : " (waited for it)");
+                return level;
+            }
+        }
+        return build(mapManager_.getMapFilename(mapNumber), mapNumber, rules, seed);
+    }
+
+private:
+    static PreparedLevel build(std::string filename, int mapNumber, SpawnRules rules, unsigned int seed) {
+        PreparedLevel level;
+        level.mapNumber = mapNumber;
+        level.filename = filename;
+        level.tilesheetPath = tilesheetForMap(mapNumber);
+
+        if (!std::filesystem::exists(filename)) {
+            LOG_ERROR(LogCategory::Map, "Map {} does not exist!", filename);
+            return level;
+        }
+
+        // A wave file next to the map says what spawns; without one it is the usual five
+        std::string wavesPath = wavePlanPathForMap(filename);
+        if (!std::filesystem::exists(wavesPath) || !level.waves.load(wavesPath)) {
+            level.waves = WavePlan::standard(enemyKindForMap(mapNumber));
+        }
+        if (isChunkedMapFile(filename)) {
+            level.streamed = true;
+            level.loaded = true;
+            return level; // Chunks and spawns are only known once streamed in
+        }
+        if (!level.map.load(filename)) {
+            LOG_ERROR(LogCategory::Map, "Failed to load map: {}", filename);
+            return level;
+        }
+        level.loaded = true;
+
+        // Reading every passability byte also faults the mapped pages in off the main thread
+        const TileMap& map = level.map;
+        level.nav.build(map.getWidth(), map.getHeight(), [&map](int x, int y) { return map.isTilePassable(x, y); });
+
+        // List the tiles enemies may spawn on, then pre-roll the opening wave from it
+        level.spawnTable.build(rules, sf::FloatRect({ 0.f, 0.f }, map.getPixelSize()), level.nav,
+            [&map](int x, int y) { return map.isTilePassable(x, y); });
+        if (level.spawnTable.isEmpty()) {
+            LOG_WARNING(LogCategory::Spawn, "Map {} has no tile an enemy can spawn on", mapNumber);
+        }
+        Random random(seed);
+        level.spawnTable.pickWave(random, level.waves.getOpeningCount(), level.spawnPoints);
+        return level;
+    }
+
+    const MapManager& mapManager_;
+    std::future<PreparedLevel> pending_;
+    int pendingMap_ = -1;
+};
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+// Game log that never blocks the frame: LOG_INFO(LogCategory::Map, "Loaded map {}", n)
+// copies the format string pointer and the arguments into a fixed-size record in a
+// lock-free queue; a background thread turns records into text and writes them out. When
+// the queue is full records are dropped (and counted) rather than waiting.
+//
+// Messages below ASHVALE_LOG_LEVEL are compiled out: 0 keeps everything, 2 (Info) strips
+// the debug chatter, 3 keeps only warnings and errors.
+#ifndef ASHVALE_LOG_LEVEL
+#define ASHVALE_LOG_LEVEL 1
+#endif
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+};
+
+enum class LogCategory : uint8_t {
+    Game,
+    Audio,
+    Combat,
+    Player,
+    Spawn,
+    Map,
+    Assets,
+};
+
+inline const char* logLevelName(LogLevel level) {
+    static const char* const names[] = { "trace", "debug", "info", "warning", "error" };
+    return names[static_cast<size_t>(level)];
+}
+
+inline const char* logCategoryName(LogCategory category) {
+    static const char* const names[] = { "game", "audio", "combat", "player", "spawn", "map", "assets" };
+    return names[static_cast<size_t>(category)];
+}
+
+// One message, unformatted. Strings are copied (and truncated) into text; everything else
+// is stored as-is.
+struct LogRecord {
+    static constexpr size_t MAX_ARGS = 6;
+    static constexpr size_t TEXT_CAPACITY = 96;
+
+    struct Arg {
+        enum class Type : uint8_t { Int, UInt, Float, Text };
+        Type type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double f;
+            struct {
+                uint16_t offset;
+                uint16_t length;
+            } text;
+        };
+    };
+
+    int64_t time;           // Nanoseconds since the logger started
+    const char* format;     // String literal; each {} takes the next argument
+    LogLevel level;
+    LogCategory category;
+    uint8_t argCount = 0;
+    uint16_t textUsed = 0;
+    Arg args[MAX_ARGS];
+    char text[TEXT_CAPACITY];
+
+    template <typename T>
+    void add(const T& value) {
+        if (argCount == MAX_ARGS) return;
+        Arg& arg = args[argCount++];
+        using Decayed = std::decay_t<T>;
+        if constexpr (std::is_floating_point_v<Decayed>) {
+            arg.type = Arg::Type::Float;
+            arg.f = static_cast<double>(value);
+        } else if constexpr (std::is_same_v<Decayed, bool>) {
+            addText(arg, value ? "true" : "false");
+        } else if constexpr (std::is_integral_v<Decayed> && std::is_signed_v<Decayed>) {
+            arg.type = Arg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral_v<Decayed>) {
+            arg.type = Arg::Type::UInt;
+            arg.u = static_cast<uint64_t>(value);
+        } else if constexpr (std::is_enum_v<Decayed>) {
+            arg.type = Arg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else {
+            addText(arg, std::string_view(value));
+        }
+    }
+
+private:
+    void addText(Arg& arg, std::string_view value) {
+        size_t length = std::min(value.size(), TEXT_CAPACITY - textUsed);
+        arg.type = Arg::Type::Text;
+        arg.text.offset = textUsed;
+        arg.text.length = static_cast<uint16_t>(length);
+        std::memcpy(text + textUsed, value.data(), length);
+        textUsed = static_cast<uint16_t>(textUsed + length);
+    }
+};
+
+class Logger {
+public:
+    static constexpr size_t CAPACITY = 4096; // Records; power of two
+
+    Logger() : cells_(new Cell[CAPACITY]), start_(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer_ = std::thread([this] { writeLoop(); });
+    }
+
+    // Writes out whatever is queued before stopping
+    ~Logger() {
+        running_.store(false, std::memory_order_release);
+        writer_.join();
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Runtime filter on top of ASHVALE_LOG_LEVEL
+    void setMinimumLevel(LogLevel level) { minimumLevel_.store(level, std::memory_order_relaxed); }
+
+    // Any thread; never blocks
+    template <typename... Args>
+    void log(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+        if (level < minimumLevel_.load(std::memory_order_relaxed)) return;
+
+        LogRecord record;
+        record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        record.format = format;
+        record.level = level;
+        record.category = category;
+        (record.add(args), ...);
+        if (!push(record)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Waits until everything logged so far has been written; for before printing reports
+    // straight to the console, or before exiting
+    void flush() {
+        size_t target = enqueuePosition_.load(std::memory_order_acquire);
+        while (written_.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::cout.flush();
+    }
+
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // Bounded multi-producer queue (Vyukov): a cell's sequence says whose turn it is
+    struct Cell {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    bool push(const LogRecord& record) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[position & (CAPACITY - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false;   // Full
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Writer thread only
+    bool pop(LogRecord& record) {
+        Cell& cell = cells_[dequeuePosition_ & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) return false;
+        record = cell.record;
+        cell.sequence.store(dequeuePosition_ + CAPACITY, std::memory_order_release);
+        ++dequeuePosition_;
+        return true;
+    }
+
+    void writeLoop() {
+        LogRecord record;
+        std::string line;
+        uint64_t reportedDropped = 0;
+        while (true) {
+            bool stopping = !running_.load(std::memory_order_acquire);
+            size_t batch = 0;
+            while (pop(record)) {
+                format(record, line);
+                (record.level >= LogLevel::Warning ? std::cerr : std::cout) << line;
+                ++batch;
+            }
+            if (batch > 0) {
+                std::cout.flush();
+                written_.fetch_add(batch, std::memory_order_release);
+            }
+
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != reportedDropped) {
+                std::cerr << "[log] " << dropped - reportedDropped << " message(s) dropped, queue full" << std::endl;
+                reportedDropped = dropped;
+            }
+
+            if (stopping) break;
+            if (batch == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    }
+
+    // "[   12.345] combat: Enemy Health: 3"; warnings and errors are marked
+    static void format(const LogRecord& record, std::string& line) {
+        char prefix[64];
+        std::snprintf(prefix, sizeof(prefix), "[%9.3f] %s: ", record.time / 1e9, logCategoryName(record.category));
+        line = prefix;
+        if (record.level >= LogLevel::Warning) {
+            line += logLevelName(record.level);
+            line += ": ";
+        }
+
+        size_t argIndex = 0;
+        for (const char* c = record.format; *c; ++c) {
+            if (c[0] == '{' && c[1] == '}' && argIndex < record.argCount) {
+                appendArg(record, record.args[argIndex++], line);
+                ++c;
+            } else {
+                line += *c;
+            }
+        }
+        line += '\n';
+    }
+
+    static void appendArg(const LogRecord& record, const LogRecord::Arg& arg, std::string& line) {
+        char buffer[32];
+        switch (arg.type) {
+        case LogRecord::Arg::Type::Int:
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(arg.i));
+            line += buffer;
+            break;
+        case LogRecord::Arg::Type::UInt:
+            std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(arg.u));
+            line += buffer;
+            break;
+        case LogRecord::Arg::Type::Float:
+            std::snprintf(buffer, sizeof(buffer), "%g", arg.f);
+            line += buffer;
+            break;
+        case LogRecord::Arg::Type::Text:
+            line.append(record.text + arg.text.offset, arg.text.length);
+            break;
+        }
+    }
+
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> enqueuePosition_{ 0 };
+    alignas(64) size_t dequeuePosition_ = 0;
+    std::atomic<size_t> written_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+    std::atomic<LogLevel> minimumLevel_{ LogLevel::Trace };
+    std::atomic<bool> running_{ true };
+    std::chrono::steady_clock::time_point start_;
+    std::thread writer_;
+};
+
+inline Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+#define ASHVALE_LOG(level, category, ...) logger().log(level, category, __VA_ARGS__)
+
+#if ASHVALE_LOG_LEVEL <= 0
+#define LOG_TRACE(category, ...) ASHVALE_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) ((void)0)
+#endif
+
+#if ASHVALE_LOG_LEVEL <= 1
+#define LOG_DEBUG(category, ...) ASHVALE_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) ((void)0)
+#endif
+
+#if ASHVALE_LOG_LEVEL <= 2
+#define LOG_INFO(category, ...) ASHVALE_LOG(LogLevel::Info, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) ((void)0)
+#endif
+
+#define LOG_WARNING(category, ...) ASHVALE_LOG(LogLevel::Warning, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) ASHVALE_LOG(LogLevel::Error, category, __VA_ARGS__)
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+
+// Constants from TileMapEditor.cpp
+const int TILE_SIZE = 16; // Base size of each tile in pixels
+const int SCALE_FACTOR = 3; // Scale factor for map window only
+const int SCALED_TILE_SIZE = TILE_SIZE * SCALE_FACTOR;
+
+// Map dimensions are stored in the map file. Legacy files have no header and are always
+// this size (in tiles).
+const int LEGACY_MAP_WIDTH = 80;
+const int LEGACY_MAP_HEIGHT = 45;
+const int MAX_MAP_DIMENSION = 4096;
+
+// Map files are little-endian and start with a MapFileHeader.
+//
+// Version 2 (whole map):
+//   TileRecord[width * height]     row-major
+//   uint8_t passable[width * height]
+//
+// Version 3 (chunked, for maps that are streamed in):
+//   ChunkTableHeader
+//   ChunkIndexEntry[chunkCount]    row-major over chunks
+//   per chunk: TileRecord[chunkSize^2] then uint8_t passable[chunkSize^2]; chunks on the
+//   right and bottom edges are padded to full size. A chunk with size 0 is empty
+//   (nothing placed, everything passable) and has no data.
+const uint32_t MAP_FILE_MAGIC = 0x504D5641; // "AVMP"
+const uint16_t MAP_FILE_VERSION = 2;
+const uint16_t CHUNKED_MAP_FILE_VERSION = 3;
+const int DEFAULT_CHUNK_SIZE = 32; // Tiles per chunk side
+
+struct MapFileHeader {
+    uint32_t magic = MAP_FILE_MAGIC;
+    uint16_t version = MAP_FILE_VERSION;
+    uint16_t tileSize = TILE_SIZE;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    bool hasValidSize() const {
+        return width > 0 && height > 0 && width <= MAX_MAP_DIMENSION && height <= MAX_MAP_DIMENSION;
+    }
+};
+static_assert(sizeof(MapFileHeader) == 16, "MapFileHeader must match the file layout");
+
+struct ChunkTableHeader {
+    uint32_t chunkSize = DEFAULT_CHUNK_SIZE;
+    uint32_t chunkCount = 0;
+};
+static_assert(sizeof(ChunkTableHeader) == 8, "ChunkTableHeader must match the file layout");
+
+struct ChunkIndexEntry {
+    uint64_t offset = 0; // From the start of the file
+    uint32_t size = 0;   // Bytes; 0 for an empty chunk
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(ChunkIndexEntry) == 16, "ChunkIndexEntry must match the file layout");
+
+// Tilesheet rect of one cell; an empty rect means nothing is placed there
+struct TileRecord {
+    uint16_t x = 0;
+    uint16_t y = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    bool isPlaced() const { return width != 0 && height != 0; }
+    sf::IntRect getTextureRect() const { return sf::IntRect({ x, y }, { width, height }); }
+};
+static_assert(sizeof(TileRecord) == 8, "TileRecord must match the file layout");
+
+// Bytes of one chunk's data in a version 3 file
+inline size_t chunkDataSize(int chunkSize) {
+    return static_cast<size_t>(chunkSize) * chunkSize * (sizeof(TileRecord) + sizeof(uint8_t));
+}
+
+// Reads just the header; false for legacy (headerless) files
+inline bool readMapFileHeader(const std::string& filename, MapFileHeader& header) {
+    std::ifstream file(filename, std::ios::binary);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return file && header.magic == MAP_FILE_MAGIC;
+}
+
+inline bool isChunkedMapFile(const std::string& filename) {
+    MapFileHeader header;
+    return readMapFileHeader(filename, header) && header.version == CHUNKED_MAP_FILE_VERSION;
+}
+
+// Tile range [first, last) covering a world-pixel rectangle, clamped to width x height
+inline sf::IntRect visibleTileRange(const sf::FloatRect& area, int width, int height) {
+    int firstX = std::max(0, static_cast<int>(std::floor(area.position.x / SCALED_TILE_SIZE)));
+    int firstY = std::max(0, static_cast<int>(std::floor(area.position.y / SCALED_TILE_SIZE)));
+    int lastX = std::min(width, static_cast<int>(std::ceil((area.position.x + area.size.x) / SCALED_TILE_SIZE)));
+    int lastY = std::min(height, static_cast<int>(std::ceil((area.position.y + area.size.y) / SCALED_TILE_SIZE)));
+    return sf::IntRect({ firstX, firstY }, { std::max(0, lastX - firstX), std::max(0, lastY - firstY) });
+}
+
+// Non-owning view of a tile array and its passability plane, as laid out in the file.
+// Used for whole maps and for single streamed chunks.
+struct TileGridView {
+    const TileRecord* tiles = nullptr;
+    const uint8_t* passable = nullptr;
+    int stride = 0; // Tiles per row
+
+    // Queue the placed tiles of a local range; origin is the grid's position in the map (tiles).
+    // Tile rects are relative to the tilesheet's atlas region.
+    void draw(SpriteBatch& batch, const AtlasRegion& tilesheet, const sf::IntRect& range, sf::Vector2i origin,
+        sf::Color impassableTint = sf::Color::White) const {
+        for (int y = range.position.y; y < range.position.y + range.size.y; ++y) {
+            for (int x = range.position.x; x < range.position.x + range.size.x; ++x) {
+                size_t index = static_cast<size_t>(y) * stride + x;
+                const TileRecord& tile = tiles[index];
+                if (!tile.isPlaced()) continue;
+
+                sf::IntRect atlasRect(tilesheet.rect.position + sf::Vector2i(tile.x, tile.y), sf::Vector2i(tile.width, tile.height));
+
+                // Scale then translate, same as a scaled sf::Sprite at the tile position
+                sf::Transform transform(SCALE_FACTOR, 0.f, static_cast<float>((origin.x + x) * SCALED_TILE_SIZE),
+                    0.f, SCALE_FACTOR, static_cast<float>((origin.y + y) * SCALED_TILE_SIZE),
+                    0.f, 0.f, 1.f);
+
+                // The editor tints non-passable tiles; the game draws them untinted
+                batch.draw(*tilesheet.page, atlasRect, transform, passable[index] ? sf::Color::White : impassableTint);
+            }
+        }
+    }
+};
@@ -6,156 +6,419 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "MapFormat.h"
+#include "ChunkStreamer.h"
+#include "MappedFile.h"
+#include "NavGrid.h"
+#include "Counters.h"
+#include "Log.h"
 
-// Constants from TileMapEditor.cpp
-const int TILE_SIZE = 16; // Base size of each tile in pixels
-const int SCALE_FACTOR = 3; // Scale factor for map window only
-const int SCALED_TILE_SIZE = TILE_SIZE * SCALE_FACTOR;
-const int MAP_WIDTH_PIXELS = 1280; // Width of the map in pixels
-const int MAP_HEIGHT_PIXELS = 720; // Height of the map in pixels
-const int MAP_WIDTH = MAP_WIDTH_PIXELS / TILE_SIZE; // Width of the map (in tiles)
-const int MAP_HEIGHT = MAP_HEIGHT_PIXELS / TILE_SIZE; // Height of the map (in tiles)
-
-class Tile {
+// Tiles and passability are kept as two flat planes, the same layout as the file. A
+// version 2 file is memory-mapped and its planes are used in place, so loading costs
+// nothing up front; other formats are read into owned arrays.
+class TileMap {
 public:
-    Tile() : textureRect(sf::IntRect({ 0, 0 }, { TILE_SIZE, TILE_SIZE })), isPlaced(false), isPassable(true) {}
-    Tile(const sf::IntRect& rect) : textureRect(rect), isPlaced(true), isPassable(true) {}
+    TileMap(int width = LEGACY_MAP_WIDTH, int height = LEGACY_MAP_HEIGHT) {
+        resize(width, height);
+    }
+
+    int getWidth() const { return width_; }
+    int getHeight() const { return height_; }
 
-    const sf::IntRect& getTextureRect() const { return textureRect; }
-    void setTextureRect(const sf::IntRect& rect) {
-        textureRect = rect;
-        isPlaced = true;
+    // Size of the map in world pixels
+    sf::Vector2f getPixelSize() const {
+        return sf::Vector2f(static_cast<float>(width_ * SCALED_TILE_SIZE), static_cast<float>(height_ * SCALED_TILE_SIZE));
     }
-    bool hasBeenPlaced() const { return isPlaced; }
 
-    bool isPassableByPlayer() const { return isPassable; }
-    void setPassable(bool passable) { isPassable = passable; }
+    // Queue the placed tiles that overlap visibleArea (world pixels); tile rects are
+    // relative to the tilesheet's atlas region
+    void draw(SpriteBatch& batch, const AtlasRegion& tilesheet, const sf::FloatRect& visibleArea,
+        sf::Color impassableTint = sf::Color::White) const {
+        if (!tilesheet.isValid()) return;
 
-private:
-    sf::IntRect textureRect;
-    bool isPlaced;
-    bool isPassable;
-};
+        TileGridView view{ tiles_, passable_, width_ };
+        view.draw(batch, tilesheet, visibleTileRange(visibleArea, width_, height_), sf::Vector2i(0, 0), impassableTint);
+    }
 
-class TileMap {
-public:
-    TileMap(int width, int height) {
-        map.resize(height, std::vector<Tile>(width));
-    }
-
-    void draw(sf::RenderWindow& window, const sf::Texture& tilesheet) {
-        for (int y = 0; y < MAP_HEIGHT; ++y) {
-            for (int x = 0; x < MAP_WIDTH; ++x) {
-                const auto& tile = map[y][x];
-                if (tile.hasBeenPlaced()) {
-                    const auto& tileRect = tile.getTextureRect();
-                    sf::Sprite sprite(tilesheet);
-                    sprite.setTextureRect(tileRect);
-                    sprite.setPosition(sf::Vector2f(static_cast<float>(x * SCALED_TILE_SIZE),
-                        static_cast<float>(y * SCALED_TILE_SIZE)));
-                    sprite.setScale(sf::Vector2f(SCALE_FACTOR, SCALE_FACTOR));
-
-                    // No red tint for non-passable tiles
-                    sprite.setColor(sf::Color::White);
-
-                    window.draw(sprite);
-                }
-            }
-        }
+    void draw(SpriteBatch& batch, const AtlasRegion& tilesheet, sf::Color impassableTint = sf::Color::White) const {
+        draw(batch, tilesheet, sf::FloatRect({ 0.f, 0.f }, getPixelSize()), impassableTint);
     }
 
     void setTile(int x, int y, const sf::IntRect& textureRect, bool passable = true) {
-        if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
-            map[y][x].setTextureRect(textureRect);
-            map[y][x].setPassable(passable);
+        if (x >= 0 && x < width_ && y >= 0 && y < height_) {
+            if (editTiles_ == nullptr) detach();
+            editTiles_[index(x, y)] = toRecord(textureRect);
+            editPassable_[index(x, y)] = passable ? 1 : 0;
         }
     }
 
+    bool isMapped() const { return mapping_.isOpen(); }
+
     bool isTilePassable(int x, int y) const {
-        if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
-            return map[y][x].isPassableByPlayer();
+        if (x >= 0 && x < width_ && y >= 0 && y < height_) {
+            return passable_[index(x, y)] != 0;
         }
         return false; // Out of bounds is considered non-passable
     }
 
-    void save(const std::string& filename) {
-        std::ofstream file(filename, std::ios::binary);
-        if (file) {
-            for (const auto& row : map) {
-                for (const auto& tile : row) {
-                    bool placed = tile.hasBeenPlaced();
-                    file.write(reinterpret_cast<const char*>(&placed), sizeof(placed));
-                    if (placed) {
-                        const auto& rect = tile.getTextureRect();
-                        file.write(reinterpret_cast<const char*>(&rect.position.x), sizeof(rect.position.x));
-                        file.write(reinterpret_cast<const char*>(&rect.position.y), sizeof(rect.position.y));
-                        file.write(reinterpret_cast<const char*>(&rect.size.x), sizeof(rect.size.x));
-                        file.write(reinterpret_cast<const char*>(&rect.size.y), sizeof(rect.size.y));
-
-                        // Save passable property
-                        bool passable = tile.isPassableByPlayer();
-                        file.write(reinterpret_cast<const char*>(&passable), sizeof(passable));
+    // Whole-map (version 2) file
+    bool save(const std::string& filename) {
+        detach(); // The file being replaced may be the one mapped
+        std::string temporary = filename + ".tmp";
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file) return false;
+
+        MapFileHeader header;
+        header.width = static_cast<uint32_t>(width_);
+        header.height = static_cast<uint32_t>(height_);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(tiles_), tileCount() * sizeof(TileRecord));
+        file.write(reinterpret_cast<const char*>(passable_), tileCount());
+        return replaceMapFile(file, temporary, filename);
+    }
+
+    // Chunked (version 3) file for maps the game should stream in
+    bool saveChunked(const std::string& filename, int chunkSize = DEFAULT_CHUNK_SIZE) {
+        detach();
+        std::string temporary = filename + ".tmp";
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file) return false;
+
+        int chunksX = (width_ + chunkSize - 1) / chunkSize;
+        int chunksY = (height_ + chunkSize - 1) / chunkSize;
+
+        MapFileHeader header;
+        header.version = CHUNKED_MAP_FILE_VERSION;
+        header.width = static_cast<uint32_t>(width_);
+        header.height = static_cast<uint32_t>(height_);
+        ChunkTableHeader table;
+        table.chunkSize = static_cast<uint32_t>(chunkSize);
+        table.chunkCount = static_cast<uint32_t>(chunksX * chunksY);
+
+        // Gather each chunk (padded to full size) and lay out the index
+        size_t tileCount = static_cast<size_t>(chunkSize) * chunkSize;
+        std::vector<ChunkIndexEntry> chunkTable(table.chunkCount);
+        std::vector<std::vector<TileRecord>> chunkTiles(table.chunkCount);
+        std::vector<std::vector<uint8_t>> chunkPassable(table.chunkCount);
+        uint64_t offset = sizeof(header) + sizeof(table) + chunkTable.size() * sizeof(ChunkIndexEntry);
+        for (int chunkY = 0; chunkY < chunksY; ++chunkY) {
+            for (int chunkX = 0; chunkX < chunksX; ++chunkX) {
+                size_t chunk = static_cast<size_t>(chunkY) * chunksX + chunkX;
+                chunkTiles[chunk].assign(tileCount, TileRecord());
+                chunkPassable[chunk].assign(tileCount, 1);
+                bool empty = true;
+                for (int y = 0; y < chunkSize; ++y) {
+                    for (int x = 0; x < chunkSize; ++x) {
+                        int mapX = chunkX * chunkSize + x;
+                        int mapY = chunkY * chunkSize + y;
+                        if (mapX >= width_ || mapY >= height_) continue;
+                        size_t local = static_cast<size_t>(y) * chunkSize + x;
+                        chunkTiles[chunk][local] = tiles_[index(mapX, mapY)];
+                        chunkPassable[chunk][local] = passable_[index(mapX, mapY)];
+                        empty = empty && !tiles_[index(mapX, mapY)].isPlaced() && passable_[index(mapX, mapY)] != 0;
                     }
                 }
+                if (!empty) {
+                    chunkTable[chunk].offset = offset;
+                    chunkTable[chunk].size = static_cast<uint32_t>(chunkDataSize(chunkSize));
+                    offset += chunkTable[chunk].size;
+                }
             }
         }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&table), sizeof(table));
+        file.write(reinterpret_cast<const char*>(chunkTable.data()), chunkTable.size() * sizeof(ChunkIndexEntry));
+        for (size_t chunk = 0; chunk < chunkTable.size(); ++chunk) {
+            if (chunkTable[chunk].size == 0) continue;
+            file.write(reinterpret_cast<const char*>(chunkTiles[chunk].data()), tileCount * sizeof(TileRecord));
+            file.write(reinterpret_cast<const char*>(chunkPassable[chunk].data()), tileCount);
+        }
+        return replaceMapFile(file, temporary, filename);
     }
 
-    void load(const std::string& filename) {
+    // Loads any format, chunked files included; the map takes the dimensions stored in the
+    // file. Version 2 files are mapped: ReadOnly for the game, CopyOnWrite for the editor so
+    // only the pages it paints on get copied.
+    bool load(const std::string& filename, MappedFile::Mode mode = MappedFile::Mode::ReadOnly) {
         std::ifstream file(filename, std::ios::binary);
-        if (file) {
-            for (auto& row : map) {
-                for (auto& tile : row) {
-                    bool placed;
-                    file.read(reinterpret_cast<char*>(&placed), sizeof(placed));
-                    if (placed) {
-                        sf::IntRect rect;
-                        file.read(reinterpret_cast<char*>(&rect.position.x), sizeof(rect.position.x));
-                        file.read(reinterpret_cast<char*>(&rect.position.y), sizeof(rect.position.y));
-                        file.read(reinterpret_cast<char*>(&rect.size.x), sizeof(rect.size.x));
-                        file.read(reinterpret_cast<char*>(&rect.size.y), sizeof(rect.size.y));
-                        tile.setTextureRect(rect);
-
-                        // Load passable property if it exists in the file
-                        bool passable = true;
-                        if (file.peek() != EOF) {
-                            file.read(reinterpret_cast<char*>(&passable), sizeof(passable));
-                            tile.setPassable(passable);
-                        }
-                    }
-                }
+        if (!file) return false;
+
+        MapFileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (file && header.magic == MAP_FILE_MAGIC) {
+            if (header.version == CHUNKED_MAP_FILE_VERSION && header.hasValidSize()) {
+                return loadChunked(file, header, filename);
+            }
+            if (header.version != MAP_FILE_VERSION || !header.hasValidSize()) {
+                LOG_ERROR(LogCategory::Map, "Unsupported map file: {}", filename);
+                return false;
             }
+            file.close();
+            return loadMapped(filename, header, mode);
         }
+
+        file.clear();
+        file.seekg(0);
+        return loadLegacy(file);
     }
 
 private:
-    std::vector<std::vector<Tile>> map;
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+    size_t tileCount() const { return static_cast<size_t>(width_) * height_; }
+
+    // Blank map in owned arrays
+    void resize(int width, int height) {
+        mapping_.close();
+        width_ = width;
+        height_ = height;
+        ownedTiles_.assign(tileCount(), TileRecord());
+        ownedPassable_.assign(tileCount(), 1);
+        tiles_ = editTiles_ = ownedTiles_.data();
+        passable_ = editPassable_ = ownedPassable_.data();
+    }
+
+    // Point the planes into the mapped file; no tile is read here
+    bool loadMapped(const std::string& filename, const MapFileHeader& header, MappedFile::Mode mode) {
+        MappedFile mapping;
+        if (!mapping.open(filename, mode)) {
+            LOG_ERROR(LogCategory::Map, "Failed to map map file: {}", filename);
+            return false;
+        }
+        size_t count = static_cast<size_t>(header.width) * header.height;
+        if (mapping.size() < sizeof(MapFileHeader) + count * (sizeof(TileRecord) + sizeof(uint8_t))) {
+            LOG_ERROR(LogCategory::Map, "Map file is truncated: {}", filename);
+            return false;
+        }
+
+        ownedTiles_.clear();
+        ownedPassable_.clear();
+        ownedTiles_.shrink_to_fit();
+        ownedPassable_.shrink_to_fit();
+        mapping_ = std::move(mapping);
+        width_ = static_cast<int>(header.width);
+        height_ = static_cast<int>(header.height);
+
+        const uint8_t* base = mapping_.data();
+        tiles_ = reinterpret_cast<const TileRecord*>(base + sizeof(MapFileHeader));
+        passable_ = base + sizeof(MapFileHeader) + count * sizeof(TileRecord);
+        uint8_t* writable = mapping_.writableData();
+        editTiles_ = writable ? reinterpret_cast<TileRecord*>(writable + sizeof(MapFileHeader)) : nullptr;
+        editPassable_ = writable ? writable + sizeof(MapFileHeader) + count * sizeof(TileRecord) : nullptr;
+        return true;
+    }
+
+    // Copy a mapped map into owned arrays and drop the mapping
+    void detach() {
+        if (!mapping_.isOpen()) return;
+        ownedTiles_.assign(tiles_, tiles_ + tileCount());
+        ownedPassable_.assign(passable_, passable_ + tileCount());
+        mapping_.close();
+        tiles_ = editTiles_ = ownedTiles_.data();
+        passable_ = editPassable_ = ownedPassable_.data();
+    }
+
+    // Write to a temporary file and rename it over the target, so a game that has the old
+    // file mapped keeps its pages instead of seeing a truncated file
+    static bool replaceMapFile(std::ofstream& file, const std::string& temporary, const std::string& filename) {
+        file.close();
+        std::error_code error;
+        if (file.fail()) {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        std::filesystem::rename(temporary, filename, error);
+        if (error) {
+            std::cerr << "Could not replace " << filename << " (is it open in the game?): " << error.message() << std::endl;
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    static TileRecord toRecord(const sf::IntRect& rect) {
+        return TileRecord{ static_cast<uint16_t>(rect.position.x), static_cast<uint16_t>(rect.position.y),
+            static_cast<uint16_t>(rect.size.x), static_cast<uint16_t>(rect.size.y) };
+    }
+
+    // Reads every chunk at once (the editor); the game streams chunked maps instead
+    bool loadChunked(std::ifstream& file, const MapFileHeader& header, const std::string& filename) {
+        ChunkTableHeader table;
+        file.read(reinterpret_cast<char*>(&table), sizeof(table));
+        int chunkSize = static_cast<int>(table.chunkSize);
+        if (!file || chunkSize <= 0 || chunkSize > MAX_MAP_DIMENSION) {
+            LOG_ERROR(LogCategory::Map, "Unsupported map file: {}", filename);
+            return false;
+        }
+
+        resize(static_cast<int>(header.width), static_cast<int>(header.height));
+        int chunksX = (width_ + chunkSize - 1) / chunkSize;
+        int chunksY = (height_ + chunkSize - 1) / chunkSize;
+        if (table.chunkCount != static_cast<uint32_t>(chunksX * chunksY)) {
+            LOG_ERROR(LogCategory::Map, "Chunk index does not match the map size: {}", filename);
+            return false;
+        }
+        std::vector<ChunkIndexEntry> chunkTable(table.chunkCount);
+        file.read(reinterpret_cast<char*>(chunkTable.data()), chunkTable.size() * sizeof(ChunkIndexEntry));
+
+        size_t tileCount = static_cast<size_t>(chunkSize) * chunkSize;
+        std::vector<TileRecord> chunkTiles(tileCount);
+        std::vector<uint8_t> chunkPassable(tileCount);
+        for (size_t chunk = 0; chunk < chunkTable.size() && file; ++chunk) {
+            if (chunkTable[chunk].size == 0) continue;
+            file.seekg(static_cast<std::streamoff>(chunkTable[chunk].offset));
+            file.read(reinterpret_cast<char*>(chunkTiles.data()), tileCount * sizeof(TileRecord));
+            file.read(reinterpret_cast<char*>(chunkPassable.data()), tileCount);
+
+            int originX = static_cast<int>(chunk % chunksX) * chunkSize;
+            int originY = static_cast<int>(chunk / chunksX) * chunkSize;
+            for (int y = 0; y < chunkSize && originY + y < height_; ++y) {
+                for (int x = 0; x < chunkSize && originX + x < width_; ++x) {
+                    size_t local = static_cast<size_t>(y) * chunkSize + x;
+                    ownedTiles_[index(originX + x, originY + y)] = chunkTiles[local];
+                    ownedPassable_[index(originX + x, originY + y)] = chunkPassable[local];
+                }
+            }
+        }
+        if (!file) {
+            LOG_ERROR(LogCategory::Map, "Map file is truncated: {}", filename);
+            return false;
+        }
+        return true;
+    }
+
+    // Headerless format: per tile a placed flag, then the rect and passable flag if placed
+    bool loadLegacy(std::ifstream& file) {
+        resize(LEGACY_MAP_WIDTH, LEGACY_MAP_HEIGHT);
+        for (size_t i = 0; i < ownedTiles_.size(); ++i) {
+            bool placed;
+            file.read(reinterpret_cast<char*>(&placed), sizeof(placed));
+            if (placed) {
+                int32_t rect[4];
+                file.read(reinterpret_cast<char*>(rect), sizeof(rect));
+                ownedTiles_[i] = toRecord(sf::IntRect({ rect[0], rect[1] }, { rect[2], rect[3] }));
+
+                // Load passable property if it exists in the file
+                bool passable = true;
+                if (file.peek() != EOF) {
+                    file.read(reinterpret_cast<char*>(&passable), sizeof(passable));
+                    ownedPassable_[i] = passable ? 1 : 0;
+                }
+            }
+        }
+        return true;
+    }
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<TileRecord> ownedTiles_;
+    std::vector<uint8_t> ownedPassable_;
+    MappedFile mapping_;
+
+    // Planes in use: the owned arrays or the mapped file. The edit pointers are null for a
+    // read-only mapping, which is detached before the first change.
+    const TileRecord* tiles_ = nullptr;
+    const uint8_t* passable_ = nullptr;
+    TileRecord* editTiles_ = nullptr;
+    uint8_t* editPassable_ = nullptr;
 };
 
 class MapManager {
 public:
-    MapManager(const std::string& mapsPath = "maps") : currentMap_(MAP_WIDTH, MAP_HEIGHT), mapsDirectory_(mapsPath) {
+    MapManager(const std::string& mapsPath = "maps") : mapsDirectory_(mapsPath) {
         // Create maps directory if it doesn't exist
         std::filesystem::create_directories(mapsDirectory_);
     }
 
+    std::string getMapFilename(int mapNumber) const {
+        return mapsDirectory_ + "/map_" + std::to_string(mapNumber) + ".dat";
+    }
+
     bool loadMap(int mapNumber) {
-        std::string filename = mapsDirectory_ + "/map_" + std::to_string(mapNumber) + ".dat";
+        std::string filename = getMapFilename(mapNumber);
         if (std::filesystem::exists(filename)) {
-            currentMap_.load(filename);
-            currentMapNumber_ = mapNumber;
-            currentMapFilename_ = filename;
-            std::cout << "Loaded map: " << filename << std::endl;
+            // Chunked maps are streamed in around the camera; everything else is read whole
+            if (isChunkedMapFile(filename)) {
+                if (!streamer_.open(filename)) {
+                    LOG_ERROR(LogCategory::Map, "Failed to load map: {}", filename);
+                    return false;
+                }
+                currentMap_ = TileMap(1, 1);
+                nav_.clear(); // Not known until every chunk has been seen
+                streaming_ = true;
+                setCurrent(mapNumber, filename);
+                return true;
+            }
+
+            TileMap map;
+            if (!map.load(filename)) {
+                LOG_ERROR(LogCategory::Map, "Failed to load map: {}", filename);
+                return false;
+            }
+            NavGrid nav;
+            nav.build(map.getWidth(), map.getHeight(), [&map](int x, int y) { return map.isTilePassable(x, y); });
+            adoptMap(mapNumber, filename, std::move(map), std::move(nav));
             return true;
         }
         else {
-            std::cout << "Map " << filename << " does not exist!" << std::endl;
+            LOG_ERROR(LogCategory::Map, "Map {} does not exist!", filename);
             return false;
         }
     }
 
-    void draw(sf::RenderWindow& window, const sf::Texture& tilesheet) {
-        currentMap_.draw(window, tilesheet);
+    // Swap in a whole map loaded elsewhere (e.g. prefetched on another thread)
+    void adoptMap(int mapNumber, const std::string& filename, TileMap&& map, NavGrid&& nav) {
+        streamer_.close();
+        streaming_ = false;
+        currentMap_ = std::move(map);
+        nav_ = std::move(nav);
+        setCurrent(mapNumber, filename);
+    }
+
+    // Only the tiles inside visibleArea (world pixels) are queued
+    void draw(SpriteBatch& batch, const AtlasRegion& tilesheet, const sf::FloatRect& visibleArea) const {
+        PROFILE_ZONE("MapManager::draw");
+        if (streaming_) {
+            streamer_.draw(batch, tilesheet, visibleArea);
+        }
+        else {
+            currentMap_.draw(batch, tilesheet, visibleArea);
+        }
+    }
+
+    // Call once per frame with the camera's visible area; streamed maps load and evict
+    // chunks around it
+    void update(const sf::FloatRect& visibleArea) {
+        if (streaming_) {
+            streamer_.update(visibleArea);
+        }
+    }
+
+    // Wait for the chunks around visibleArea to arrive (level start)
+    void streamIn(const sf::FloatRect& visibleArea) {
+        if (streaming_) {
+            streamer_.update(visibleArea);
+            streamer_.waitForRing();
+        }
+    }
+
+    // Part of the map that currently has tiles loaded, in world pixels
+    sf::FloatRect getLoadedArea() const {
+        return streaming_ ? streamer_.getStreamedArea() : sf::FloatRect({ 0.f, 0.f }, currentMap_.getPixelSize());
+    }
+
+    sf::Vector2i getMapTileSize() const {
+        return streaming_ ? sf::Vector2i(streamer_.getWidth(), streamer_.getHeight())
+            : sf::Vector2i(currentMap_.getWidth(), currentMap_.getHeight());
+    }
+
+    sf::Vector2f getMapPixelSize() const {
+        return streaming_ ? streamer_.getPixelSize() : currentMap_.getPixelSize();
     }
 
     void listAvailableMaps() {
@@ -175,27 +438,45 @@ public:
         return currentMapFilename_;
     }
 
-    // Check if a tile at the given position is passable
+    // Check if a tile at the given position is passable; tiles of chunks that are not
+    // streamed in yet are blocked
     bool isTilePassable(int x, int y) const {
-        return currentMap_.isTilePassable(x, y);
+        return streaming_ ? streamer_.isTilePassable(x, y) : currentMap_.isTilePassable(x, y);
+    }
+
+    // False when no path can exist between the two tiles; always true for streamed maps
+    bool isReachable(sf::Vector2i fromTile, sf::Vector2i toTile) const {
+        return nav_.isReachable(fromTile, toTile);
+    }
+
+    const NavGrid& getNavGrid() const {
+        return nav_;
     }
 
     // Check if a position is passable (converts from pixel coordinates to tile coordinates)
     bool isPositionPassable(float x, float y) const {
-        // Convert from pixel coordinates to tile coordinates
-        int tileX = static_cast<int>(x / SCALED_TILE_SIZE);
-        int tileY = static_cast<int>(y / SCALED_TILE_SIZE);
+        COUNTER_ADD("collision probes", 1);
 
-        // Check if the position is within the map bounds
-        if (tileX < 0 || tileX >= MAP_WIDTH || tileY < 0 || tileY >= MAP_HEIGHT) {
-            return false; // Out of bounds is considered non-passable
-        }
+        // Convert from pixel coordinates to tile coordinates
+        int tileX = static_cast<int>(std::floor(x / SCALED_TILE_SIZE));
+        int tileY = static_cast<int>(std::floor(y / SCALED_TILE_SIZE));
 
+        // Out of bounds is considered non-passable
         return isTilePassable(tileX, tileY);
     }
 
 private:
+    void setCurrent(int mapNumber, const std::string& filename) {
+        currentMapNumber_ = mapNumber;
+        currentMapFilename_ = filename;
+        LOG_INFO(LogCategory::Map, "Loaded map: {} ({}x{} tiles{})", filename, getMapTileSize().x, getMapTileSize().y,
+            streaming_ ? ", streamed" : currentMap_.isMapped() ? ", mapped" : "");
+    }
+
     TileMap currentMap_;
+    NavGrid nav_;
+    ChunkStreamer streamer_;
+    bool streaming_ = false;
     int currentMapNumber_ = 1;
     std::string currentMapFilename_;
     std::string mapsDirectory_;
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped into memory.
+//  - ReadOnly: pages come straight from the OS page cache and are shared with every
+//    other process mapping the same file.
+//  - CopyOnWrite: the mapping is writable, but a page is only copied (privately) the
+//    first time it is written; the file itself is never modified.
+class MappedFile {
+public:
+    enum class Mode { ReadOnly, CopyOnWrite };
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { moveFrom(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    bool open(const std::filesystem::path& path, Mode mode = Mode::ReadOnly) {
+        close();
+        mode_ = mode;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, mode == Mode::ReadOnly ? PAGE_READONLY : PAGE_WRITECOPY, 0, 0, nullptr);
+        CloseHandle(file); // The mapping keeps the file open
+        if (mapping == nullptr) return false;
+
+        void* view = MapViewOfFile(mapping, mode == Mode::ReadOnly ? FILE_MAP_READ : FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(mapping); // The view keeps the mapping alive
+        if (view == nullptr) return false;
+
+        data_ = static_cast<uint8_t*>(view);
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return false;
+
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size == 0) {
+            ::close(file);
+            return false;
+        }
+
+        int protection = mode == Mode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), protection, MAP_PRIVATE, file, 0);
+        ::close(file); // The mapping keeps the file open
+        if (view == MAP_FAILED) return false;
+
+        data_ = static_cast<uint8_t*>(view);
+        size_ = static_cast<size_t>(status.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+        if (data_ == nullptr) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    bool isWritable() const { return data_ != nullptr && mode_ == Mode::CopyOnWrite; }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Hint that the whole file is about to be read, so the OS can read it in ahead of use
+    void willNeed() const {
+        if (data_ == nullptr) return;
+#ifdef _WIN32
+        WIN32_MEMORY_RANGE_ENTRY range{ data_, size_ };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+        madvise(data_, size_, MADV_WILLNEED);
+#endif
+    }
+
+    // Only valid for CopyOnWrite mappings
+    uint8_t* writableData() { return isWritable() ? data_ : nullptr; }
+
+private:
+    void moveFrom(MappedFile& other) {
+        data_ = other.data_;
+        size_ = other.size_;
+        mode_ = other.mode_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    Mode mode_ = Mode::ReadOnly;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <vector>
+#include <cstdint>
+
+// Connected regions of passable tiles, using the same 8-way moves as the path finder.
+// Built once per level so unreachable goals can be rejected without running A* over
+// the whole region first.
+class NavGrid {
+public:
+    // isPassable(x, y) is queried once per tile
+    template <typename IsPassable>
+    void build(int width, int height, IsPassable isPassable) {
+        width_ = width;
+        height_ = height;
+        regionCount_ = 0;
+        regions_.assign(static_cast<size_t>(width) * height, 0);
+
+        std::vector<uint8_t> passable(regions_.size());
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                passable[index(x, y)] = isPassable(x, y) ? 1 : 0;
+            }
+        }
+
+        // Flood fill each unlabelled passable tile
+        std::vector<sf::Vector2i> stack;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!passable[index(x, y)] || regions_[index(x, y)] != 0) continue;
+
+                uint32_t region = ++regionCount_;
+                regions_[index(x, y)] = region;
+                stack.push_back({ x, y });
+                while (!stack.empty()) {
+                    sf::Vector2i tile = stack.back();
+                    stack.pop_back();
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            int nx = tile.x + dx;
+                            int ny = tile.y + dy;
+                            if (nx < 0 || nx >= width || ny < 0 || ny >= height) continue;
+                            size_t neighbor = index(nx, ny);
+                            if (!passable[neighbor] || regions_[neighbor] != 0) continue;
+                            regions_[neighbor] = region;
+                            stack.push_back({ nx, ny });
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void clear() {
+        width_ = height_ = 0;
+        regionCount_ = 0;
+        regions_.clear();
+    }
+
+    bool isBuilt() const { return !regions_.empty(); }
+    uint32_t getRegionCount() const { return regionCount_; }
+
+    // 0 for blocked or out-of-bounds tiles
+    uint32_t getRegion(int x, int y) const {
+        if (x < 0 || x >= width_ || y < 0 || y >= height_) return 0;
+        return regions_[index(x, y)];
+    }
+
+    // False only when a path can certainly not exist. A search starting on a blocked tile
+    // can still step into any neighbouring region, so that case is left to the search.
+    bool isReachable(sf::Vector2i from, sf::Vector2i to) const {
+        if (!isBuilt() || from == to) return true;
+        uint32_t goalRegion = getRegion(to.x, to.y);
+        if (goalRegion == 0) return false;
+        uint32_t startRegion = getRegion(from.x, from.y);
+        return startRegion == 0 || startRegion == goalRegion;
+    }
+
+private:
+    size_t index(int x, int y) const { return static_cast<size_t>(y) * width_ + x; }
+
+    int width_ = 0;
+    int height_ = 0;
+    uint32_t regionCount_ = 0;
+    std::vector<uint32_t> regions_;
+};
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <optional>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+#include <cstdint>
+#include "Log.h"
+
+// Scoped timing zones: PROFILE_ZONE("name") at the top of a block times the rest of it.
+// Each thread writes its zones into its own ring buffer without locking; once a frame
+// PROFILE_FRAME() drains them into rolling per-zone stats (the F3 overlay) and, while a
+// capture runs, into a Chrome trace (open it in chrome://tracing or ui.perfetto.dev).
+//
+// Building with ASHVALE_PROFILING=0 compiles every zone out.
+#ifndef ASHVALE_PROFILING
+#define ASHVALE_PROFILING 1
+#endif
+
+// Nanoseconds on a steady clock
+inline int64_t profileNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ProfileEvent {
+    const char* name;   // String literal; zones are told apart by pointer
+    int64_t start;
+    int64_t end;
+};
+
+// Single producer (the owning thread), single consumer (whoever calls endFrame)
+class ProfileBuffer {
+public:
+    static constexpr size_t CAPACITY = 1 << 14; // Power of two
+
+    explicit ProfileBuffer(uint32_t threadIndex) : threadIndex_(threadIndex), events_(new ProfileEvent[CAPACITY]) {}
+
+    // Drops the event if the consumer has fallen a whole buffer behind
+    void push(const ProfileEvent& event) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        events_[head & (CAPACITY - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    template <typename Function>
+    void drain(Function&& function) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            function(events_[tail & (CAPACITY - 1)]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    uint32_t getThreadIndex() const { return threadIndex_; }
+    uint64_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    uint32_t threadIndex_;
+    std::unique_ptr<ProfileEvent[]> events_;
+    alignas(64) std::atomic<size_t> head_{ 0 };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    std::atomic<uint64_t> dropped_{ 0 };
+};
+
+class Profiler {
+public:
+    static constexpr size_t HISTORY = 120;                  // Frames of rolling stats
+    static constexpr size_t MAX_CAPTURE_EVENTS = 1 << 20;   // Bounds a capture's memory
+
+    // The calling thread's buffer, registered on first use
+    ProfileBuffer& threadBuffer() {
+        thread_local ProfileBuffer* buffer = registerThread();
+        return *buffer;
+    }
+
+    // Once per frame, on the thread that owns the overlay
+    void endFrame() {
+        int64_t now = profileNow();
+        if (lastFrameEnd_ != 0) {
+            addFrameTime(FRAME_ZONE, now - lastFrameEnd_);
+            if (capturing_) capture(threadBuffer().getThreadIndex(), ProfileEvent{ FRAME_ZONE, lastFrameEnd_, now });
+        }
+        lastFrameEnd_ = now;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& buffer : buffers_) {
+                uint32_t thread = buffer->getThreadIndex();
+                buffer->drain([this, thread](const ProfileEvent& event) {
+                    addFrameTime(event.name, event.end - event.start);
+                    if (capturing_) capture(thread, event);
+                });
+            }
+        }
+
+        // Zones that did not run this frame count as zero
+        for (auto& [name, zone] : zones_) {
+            zone.history[zone.next] = zone.thisFrame;
+            zone.next = (zone.next + 1) % HISTORY;
+            zone.filled = std::min(zone.filled + 1, HISTORY);
+            zone.thisFrame = 0;
+        }
+        ++frameCount_;
+
+        if (capturing_ && frameCount_ >= captureEndFrame_) stopCapture();
+    }
+
+    // Frame period the game aims for, in ms; set before the first frame
+    void setFrameBudget(double milliseconds) { frameBudget_ = milliseconds; }
+
+    // Time spent working on a frame, waits for pacing, vsync and the other thread left
+    // out, so a frame rate capped below the budget does not read as overload. The render
+    // thread reports its drawing; the simulation thread its events, ticks and recording.
+    // The two overlap, so a frame costs the larger of them.
+    void reportRenderWork(int64_t nanoseconds) { renderWork_.store(nanoseconds, std::memory_order_relaxed); }
+
+    void reportSimulationWork(int64_t nanoseconds) {
+        int64_t work = std::max(nanoseconds, renderWork_.load(std::memory_order_relaxed));
+        double load = work / 1e6 / frameBudget_;
+        // Smoothed over about 8 frames, so one hitch does not count as overload
+        frameLoad_ = frameLoad_ == 0.0 ? load : frameLoad_ + (load - frameLoad_) / 8.0;
+    }
+
+    // Recent work per frame over the budget: above 1 frames cannot keep up. 0 until work
+    // has been reported. Simulation thread only.
+    double getFrameLoad() const { return frameLoad_; }
+
+    // Records the next frameCount frames, then writes them to path
+    void startCapture(const std::string& path, uint64_t frameCount) {
+        if (capturing_) return;
+        capturePath_ = path;
+        captureEndFrame_ = frameCount_ + frameCount;
+        captured_.clear();
+        capturing_ = true;
+        LOG_INFO(LogCategory::Game, "Profiler capture started ({} frames)", frameCount);
+    }
+
+    bool isCapturing() const { return capturing_; }
+
+    // Writes what has been captured so far
+    void stopCapture() {
+        if (!capturing_) return;
+        capturing_ = false;
+        writeChromeTrace(capturePath_);
+        captured_.clear();
+        captured_.shrink_to_fit();
+    }
+
+    // Per-frame time of a zone over the last HISTORY frames, in ms
+    struct ZoneSummary {
+        std::string name;
+        double average = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+    };
+
+    // Most expensive first
+    std::vector<ZoneSummary> summarize() const {
+        std::vector<ZoneSummary> summaries;
+        std::vector<int64_t> sorted;
+        for (const auto& [name, zone] : zones_) {
+            if (zone.filled == 0) continue;
+            sorted.assign(zone.history.begin(), zone.history.begin() + zone.filled);
+            std::sort(sorted.begin(), sorted.end());
+            int64_t total = 0;
+            for (int64_t time : sorted) total += time;
+
+            ZoneSummary summary;
+            summary.name = name;
+            summary.average = total / 1e6 / sorted.size();
+            summary.p95 = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)] / 1e6;
+            summary.max = sorted.back() / 1e6;
+            summaries.push_back(summary);
+        }
+        std::sort(summaries.begin(), summaries.end(), [](const ZoneSummary& a, const ZoneSummary& b) { return a.average > b.average; });
+        return summaries;
+    }
+
+    void printReport() const {
+        std::cout << "Profile (last " << std::min<uint64_t>(frameCount_, HISTORY) << " frames, ms per frame):" << std::endl;
+        for (const auto& zone : summarize()) {
+            std::cout << "  " << zone.name << ": avg " << zone.average << ", p95 " << zone.p95 << ", max " << zone.max << std::endl;
+        }
+    }
+
+    // Zone table in screen space, top left; the text is only rebuilt a few times a second
+    void drawOverlay(sf::RenderTarget& target, const sf::Font& font) {
+        if (!overlayText_ || overlayFont_ != &font) {
+            overlayFont_ = &font;
+            overlayText_.emplace(font, "", 14);
+            overlayText_->setFillColor(sf::Color::White);
+            overlayText_->setPosition(sf::Vector2f(8.f, 8.f));
+            overlayUpdatedFrame_ = 0;
+        }
+        if (frameCount_ - overlayUpdatedFrame_ >= 15 || overlayUpdatedFrame_ == 0) {
+            overlayUpdatedFrame_ = frameCount_;
+            char line[128];
+            std::string text = "zone            avg    p95    max (ms)\n";
+            for (const auto& zone : summarize()) {
+                std::snprintf(line, sizeof(line), "%-14.14s %6.2f %6.2f %6.2f\n", zone.name.c_str(), zone.average, zone.p95, zone.max);
+                text += line;
+            }
+            if (capturing_) text += "capturing...\n";
+            overlayText_->setString(text);
+
+            sf::FloatRect bounds = overlayText_->getGlobalBounds();
+            overlayBackground_.setPosition(bounds.position - sf::Vector2f(4.f, 4.f));
+            overlayBackground_.setSize(bounds.size + sf::Vector2f(8.f, 8.f));
+            overlayBackground_.setFillColor(sf::Color(0, 0, 0, 160));
+        }
+        target.draw(overlayBackground_);
+        target.draw(*overlayText_);
+    }
+
+private:
+    static constexpr const char* FRAME_ZONE = "frame";
+
+    struct Zone {
+        std::vector<int64_t> history = std::vector<int64_t>(HISTORY, 0);
+        size_t next = 0;
+        size_t filled = 0;
+        int64_t thisFrame = 0;
+    };
+
+    struct CapturedEvent {
+        ProfileEvent event;
+        uint32_t thread;
+    };
+
+    ProfileBuffer* registerThread() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(std::make_unique<ProfileBuffer>(static_cast<uint32_t>(buffers_.size())));
+        return buffers_.back().get();
+    }
+
+    void addFrameTime(const char* name, int64_t duration) {
+        zones_[name].thisFrame += duration;
+    }
+
+    void capture(uint32_t thread, const ProfileEvent& event) {
+        if (captured_.size() < MAX_CAPTURE_EVENTS) captured_.push_back(CapturedEvent{ event, thread });
+    }
+
+    // Trace Event Format: complete ("X") events in microseconds
+    void writeChromeTrace(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            LOG_ERROR(LogCategory::Game, "Failed to write profiler capture: {}", path);
+            return;
+        }
+        int64_t origin = captured_.empty() ? 0 : captured_.front().event.start;
+        for (const auto& captured : captured_) origin = std::min(origin, captured.event.start);
+
+        file << "{\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& captured : captured_) {
+            if (!first) file << ",\n";
+            first = false;
+            file << "{\"name\":\"" << captured.event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << captured.thread
+                << ",\"ts\":" << (captured.event.start - origin) / 1000.0
+                << ",\"dur\":" << (captured.event.end - captured.event.start) / 1000.0 << "}";
+        }
+        file << "\n]}\n";
+
+        uint64_t dropped = 0;
+        for (const auto& buffer : buffers_) dropped += buffer->getDropped();
+        if (dropped > 0) {
+            LOG_INFO(LogCategory::Game, "Wrote {} profiler events to {} ({} dropped since startup)", captured_.size(), path, dropped);
+        } else {
+            LOG_INFO(LogCategory::Game, "Wrote {} profiler events to {}", captured_.size(), path);
+        }
+    }
+
+    std::mutex mutex_;  // Guards buffers_; only taken to register a thread and to drain
+    std::vector<std::unique_ptr<ProfileBuffer>> buffers_;
+    std::unordered_map<const char*, Zone> zones_;
+    int64_t lastFrameEnd_ = 0;
+    uint64_t frameCount_ = 0;
+    double frameBudget_ = 1000.0 / 60.0;
+    std::atomic<int64_t> renderWork_{ 0 };
+    double frameLoad_ = 0.0;
+
+    bool capturing_ = false;
+    std::string capturePath_;
+    uint64_t captureEndFrame_ = 0;
+    std::vector<CapturedEvent> captured_;
+
+    const sf::Font* overlayFont_ = nullptr;
+    std::optional<sf::Text> overlayText_;   // sf::Text needs a font to exist
+    sf::RectangleShape overlayBackground_;
+    uint64_t overlayUpdatedFrame_ = 0;
+};
+
+inline Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
+
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : name_(name), start_(profileNow()) {}
+    ~ProfileZone() { profiler().threadBuffer().push(ProfileEvent{ name_, start_, profileNow() }); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name_;
+    int64_t start_;
+};
+
+#if ASHVALE_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(name)
+#define PROFILE_FRAME() profiler().endFrame()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+// PCG32 (O'Neill, pcg-random.org): small, fast, and unlike rand() or the std::
+// distributions it produces the same sequence on every platform and standard library,
+// so a seed fully determines a simulation run.
+class Random {
+public:
+    explicit Random(uint64_t seed = 0x853c49e6748fea9bull, uint64_t stream = 0xda3e39cb94b95bdbull) {
+        reseed(seed, stream);
+    }
+
+    void reseed(uint64_t seed, uint64_t stream = 0xda3e39cb94b95bdbull) {
+        state_ = 0;
+        increment_ = (stream << 1u) | 1u;
+        next();
+        state_ += seed;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state_;
+        state_ = old * 6364136223846793005ull + increment_;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+    // Uniform in [0, bound) without modulo bias; 0 when bound is 0
+    uint32_t below(uint32_t bound) {
+        if (bound == 0) return 0;
+        uint32_t threshold = (0u - bound) % bound;
+        while (true) {
+            uint32_t value = next();
+            if (value >= threshold) return value % bound;
+        }
+    }
+
+    // Uniform in [min, max]
+    int range(int min, int max) {
+        if (max <= min) return min;
+        return min + static_cast<int>(below(static_cast<uint32_t>(max - min) + 1u));
+    }
+
+    // Uniform in [0, 1)
+    float uniform() {
+        return static_cast<float>(next() >> 8) * (1.f / 16777216.f);
+    }
+
+    // Uniform in [min, max)
+    float uniform(float min, float max) {
+        return min + (max - min) * uniform();
+    }
+
+private:
+    uint64_t state_ = 0;
+    uint64_t increment_ = 0;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "AssetPack.h"
+#include "Compression.h"
+
+// Pre-decoded texture (.avtx): the RGBA pixels of an image, written offline so loading
+// skips PNG inflate and filtering. Little-endian:
+//   RawTextureHeader
+//   pixels             width * height * 4 bytes, row-major RGBA, either as is or as one LZ block
+const uint32_t RAW_TEXTURE_MAGIC = 0x58545641; // "AVTX"
+const uint16_t RAW_TEXTURE_VERSION = 1;
+const std::string RAW_TEXTURE_EXTENSION = ".avtx";
+
+struct RawTextureHeader {
+    uint32_t magic = RAW_TEXTURE_MAGIC;
+    uint16_t version = RAW_TEXTURE_VERSION;
+    uint8_t compression = 0;    // AssetCompression
+    uint8_t reserved = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t dataSize = 0;      // Bytes following the header
+    uint32_t reserved2 = 0;
+};
+static_assert(sizeof(RawTextureHeader) == 24, "RawTextureHeader must match the file layout");
+
+// Decoded RGBA pixels, ready for sf::Texture::update. Uncompressed files are used in
+// place, so pixels may point into the asset pack rather than into storage.
+struct DecodedImage {
+    sf::Vector2u size;
+    const uint8_t* pixels = nullptr;
+    std::vector<uint8_t> storage;
+
+    bool isValid() const { return pixels != nullptr; }
+
+    // Copy into an sf::Image, for callers that compose images on the CPU
+    sf::Image toImage() const { return isValid() ? sf::Image(size, pixels) : sf::Image(); }
+};
+
+inline bool isRawTexturePath(const std::string& path) {
+    return std::filesystem::path(path).extension() == RAW_TEXTURE_EXTENSION;
+}
+
+// Thread-safe; the data must stay alive while the image is used when it is stored uncompressed
+inline bool decodeRawTexture(const uint8_t* data, size_t size, DecodedImage& image) {
+    RawTextureHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != RAW_TEXTURE_MAGIC || header.version != RAW_TEXTURE_VERSION) return false;
+    if (header.dataSize > size - sizeof(header)) return false;
+
+    size_t pixelBytes = static_cast<size_t>(header.width) * header.height * 4;
+    const uint8_t* stored = data + sizeof(header);
+    image.size = sf::Vector2u(header.width, header.height);
+    if (header.compression == static_cast<uint8_t>(AssetCompression::None)) {
+        if (header.dataSize != pixelBytes) return false;
+        image.storage.clear();
+        image.pixels = stored;
+        return true;
+    }
+
+    image.storage.resize(pixelBytes);
+    if (!lz::decompress(stored, header.dataSize, image.storage.data(), pixelBytes)) return false;
+    image.pixels = image.storage.data();
+    return true;
+}
+
+inline std::vector<uint8_t> encodeRawTexture(const sf::Image& image, bool compress) {
+    RawTextureHeader header;
+    header.width = image.getSize().x;
+    header.height = image.getSize().y;
+    size_t pixelBytes = static_cast<size_t>(header.width) * header.height * 4;
+
+    std::vector<uint8_t> data;
+    if (compress && pixelBytes > 0) {
+        data = lz::compress(image.getPixelsPtr(), pixelBytes);
+        if (data.size() < pixelBytes) {
+            header.compression = static_cast<uint8_t>(AssetCompression::LZ);
+        }
+    }
+    if (header.compression == static_cast<uint8_t>(AssetCompression::None)) {
+        data.assign(image.getPixelsPtr(), image.getPixelsPtr() + pixelBytes);
+    }
+    header.dataSize = static_cast<uint32_t>(data.size());
+
+    std::vector<uint8_t> file(sizeof(header));
+    std::memcpy(file.data(), &header, sizeof(header));
+    file.insert(file.end(), data.begin(), data.end());
+    return file;
+}
+
+inline bool saveRawTexture(const sf::Image& image, const std::string& path, bool compress = true) {
+    std::vector<uint8_t> file = encodeRawTexture(image, compress);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    return static_cast<bool>(out);
+}
+
+// "a/b.png" -> "a/b.avtx"
+inline std::string rawTexturePathFor(const std::string& path) {
+    return std::filesystem::path(path).replace_extension(RAW_TEXTURE_EXTENSION).generic_string();
+}
+
+// Decode any image asset (.avtx or anything sf::Image reads) on the calling thread, from
+// the asset pack when it is open. A .avtx written by TextureConverter next to the image
+// is used instead of the image itself. Safe to run on worker threads.
+inline bool decodeImageAsset(const std::string& path, DecodedImage& image) {
+    if (isRawTexturePath(path)) {
+        if (AssetData asset = assetPack().get(path)) return decodeRawTexture(asset.data, asset.size, image);
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!decodeRawTexture(data.data(), data.size(), image)) return false;
+        if (image.storage.empty()) {
+            image.storage = std::move(data); // Uncompressed: keep the file bytes alive
+            image.pixels = image.storage.data() + sizeof(RawTextureHeader);
+        }
+        return true;
+    }
+
+    std::string rawPath = rawTexturePathFor(path);
+    if (assetPack().contains(rawPath) || (!assetPack().isOpen() && std::filesystem::exists(rawPath))) {
+        if (decodeImageAsset(rawPath, image)) return true;
+    }
+
+    sf::Image decoded;
+    if (!loadImageAsset(decoded, path)) return false;
+    image.size = decoded.getSize();
+    image.storage.assign(decoded.getPixelsPtr(), decoded.getPixelsPtr() + static_cast<size_t>(image.size.x) * image.size.y * 4);
+    image.pixels = image.storage.data();
+    return true;
+}
+
+// GL thread only: one allocation and one upload, no decoding
+inline bool uploadDecodedImage(sf::Texture& texture, const DecodedImage& image) {
+    if (!image.isValid() || !texture.resize(image.size)) return false;
+    texture.update(image.pixels);
+    return true;
+}
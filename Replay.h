@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include "Input.h"
+
+// A recorded session: the RNG seed and starting map plus the input of every simulation
+// step, run-length encoded (a 5 minute session is a few KB). Fed back through World::step
+// it reproduces the session exactly, windowed or headless. Little-endian:
+//   ReplayHeader
+//   ReplayRun[runCount]
+const uint32_t REPLAY_MAGIC = 0x50525641; // "AVRP"
+const uint16_t REPLAY_VERSION = 1;
+
+struct ReplayHeader {
+    uint32_t magic = REPLAY_MAGIC;
+    uint16_t version = REPLAY_VERSION;
+    uint16_t startMap = 1;
+    uint64_t seed = 0;
+    uint32_t stepCount = 0;
+    uint32_t runCount = 0;
+    uint64_t finalChecksum = 0;     // World::checksum() after the last step; 0 if unknown
+};
+static_assert(sizeof(ReplayHeader) == 32, "ReplayHeader must match the file layout");
+
+// The same input for repeat consecutive steps
+struct ReplayRun {
+    uint16_t input = 0;
+    uint16_t repeat = 0;
+};
+static_assert(sizeof(ReplayRun) == 4, "ReplayRun must match the file layout");
+
+// held in bits 0-5, confirm in bit 6, map key in bits 7-10
+inline uint16_t packInput(const InputFrame& input) {
+    return static_cast<uint16_t>((input.held & 0x3F) | (input.confirm ? 1 << 6 : 0) | ((input.mapKey & 0x0F) << 7));
+}
+
+inline InputFrame unpackInput(uint16_t packed) {
+    InputFrame input;
+    input.held = static_cast<uint8_t>(packed & 0x3F);
+    input.confirm = (packed & (1 << 6)) != 0;
+    input.mapKey = static_cast<uint8_t>((packed >> 7) & 0x0F);
+    return input;
+}
+
+class ReplayRecorder {
+public:
+    void begin(uint64_t seed, int startMap) {
+        header_ = ReplayHeader();
+        header_.seed = seed;
+        header_.startMap = static_cast<uint16_t>(startMap);
+        runs_.clear();
+    }
+
+    // Once per World::step, with the input it was given
+    void record(const InputFrame& input) {
+        uint16_t packed = packInput(input);
+        if (!runs_.empty() && runs_.back().input == packed && runs_.back().repeat < UINT16_MAX) {
+            ++runs_.back().repeat;
+        } else {
+            runs_.push_back(ReplayRun{ packed, 1 });
+        }
+        ++header_.stepCount;
+    }
+
+    uint32_t getStepCount() const { return header_.stepCount; }
+
+    bool save(const std::string& path, uint64_t finalChecksum) {
+        header_.runCount = static_cast<uint32_t>(runs_.size());
+        header_.finalChecksum = finalChecksum;
+
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        file.write(reinterpret_cast<const char*>(runs_.data()), static_cast<std::streamsize>(runs_.size() * sizeof(ReplayRun)));
+        if (!file) {
+            std::cerr << "Failed to write replay: " << path << std::endl;
+            return false;
+        }
+        std::cout << "Recorded " << header_.stepCount << " steps to " << path << std::endl;
+        return true;
+    }
+
+private:
+    ReplayHeader header_;
+    std::vector<ReplayRun> runs_;
+};
+
+class ReplayPlayer {
+public:
+    bool load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.read(reinterpret_cast<char*>(&header_), sizeof(header_)) ||
+            header_.magic != REPLAY_MAGIC || header_.version != REPLAY_VERSION) {
+            std::cerr << "Not a replay file: " << path << std::endl;
+            return false;
+        }
+        // runCount comes from the file: check it against what is left before allocating
+        const std::streamoff runsStart = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::streamoff left = file.tellg() - runsStart;
+        file.seekg(runsStart);
+        if (!file || static_cast<uint64_t>(header_.runCount) * sizeof(ReplayRun) > static_cast<uint64_t>(left)) {
+            std::cerr << "Truncated replay: " << path << std::endl;
+            return false;
+        }
+        runs_.resize(header_.runCount);
+        if (!file.read(reinterpret_cast<char*>(runs_.data()), static_cast<std::streamsize>(runs_.size() * sizeof(ReplayRun)))) {
+            std::cerr << "Truncated replay: " << path << std::endl;
+            return false;
+        }
+        run_ = 0;
+        usedInRun_ = 0;
+        step_ = 0;
+        return true;
+    }
+
+    uint64_t getSeed() const { return header_.seed; }
+    int getStartMap() const { return header_.startMap; }
+    uint32_t getStepCount() const { return header_.stepCount; }
+    uint64_t getFinalChecksum() const { return header_.finalChecksum; }
+    uint32_t getStep() const { return step_; }
+    bool isFinished() const { return run_ >= runs_.size(); }
+
+    // Input for the next step; empty input once finished
+    InputFrame next() {
+        if (isFinished()) return InputFrame();
+        InputFrame input = unpackInput(runs_[run_].input);
+        if (++usedInRun_ >= runs_[run_].repeat) {
+            ++run_;
+            usedInRun_ = 0;
+        }
+        ++step_;
+        return input;
+    }
+
+private:
+    ReplayHeader header_;
+    std::vector<ReplayRun> runs_;
+    size_t run_ = 0;
+    uint32_t usedInRun_ = 0;
+    uint32_t step_ = 0;
+};
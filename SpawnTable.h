@@ -0,0 +1,116 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include "MapFormat.h"
+#include "NavGrid.h"
+#include "Random.h"
+
+// Where the enemies of a level may appear
+struct SpawnRules {
+    sf::Vector2f playerStart;           // Player centre when the level starts
+    sf::Vector2f probeOffset;           // Point of an enemy sprite that must stand on a passable tile
+    float margin = 100.f;               // Kept clear at the right and bottom edges of the area
+    float minPlayerDistance = 250.f;    // From the player to the probe point
+};
+
+// Every tile an enemy may spawn on, listed once when a level loads: passable, in the
+// player's region (so the enemy can reach them) and not right next to them. After that a
+// spawn is one draw from the level's Random instead of guessing positions until one
+// happens to be passable, and a wave of distinct tiles is a partial shuffle.
+class SpawnTable {
+public:
+    // area is in pixels: the whole map, or the part of a streamed map that is loaded.
+    // isPassable(x, y) is asked once per tile of the area.
+    template <typename IsPassable>
+    void build(const SpawnRules& rules, sf::FloatRect area, const NavGrid& nav, IsPassable isPassable) {
+        probeOffset_ = rules.probeOffset;
+        tiles_.clear();
+
+        // The sprite's top left (probe point minus offset) has to stay inside the area
+        sf::Vector2f minPosition = area.position;
+        sf::Vector2f maxPosition = area.position + area.size - sf::Vector2f(rules.margin, rules.margin);
+        int firstX = std::max(0, static_cast<int>(std::floor(area.position.x / SCALED_TILE_SIZE)));
+        int firstY = std::max(0, static_cast<int>(std::floor(area.position.y / SCALED_TILE_SIZE)));
+        int lastX = static_cast<int>(std::ceil((area.position.x + area.size.x) / SCALED_TILE_SIZE));
+        int lastY = static_cast<int>(std::ceil((area.position.y + area.size.y) / SCALED_TILE_SIZE));
+        sf::Vector2i playerTile = toTile(rules.playerStart);
+        float minDistanceSquared = rules.minPlayerDistance * rules.minPlayerDistance;
+
+        auto scan = [&](bool keepAway) {
+            for (int y = firstY; y < lastY; ++y) {
+                for (int x = firstX; x < lastX; ++x) {
+                    sf::Vector2f position = toPosition(x, y);
+                    if (position.x < minPosition.x || position.y < minPosition.y
+                        || position.x > maxPosition.x || position.y > maxPosition.y) continue;
+                    if (!isPassable(x, y) || !nav.isReachable(playerTile, { x, y })) continue;
+                    sf::Vector2f away = position + probeOffset_ - rules.playerStart;
+                    if (keepAway && away.x * away.x + away.y * away.y < minDistanceSquared) continue;
+                    tiles_.push_back(pack(x, y));
+                }
+            }
+        };
+        scan(true);
+        // A small map may have nothing far enough away; anywhere reachable beats nothing
+        keptAway_ = !tiles_.empty();
+        if (!keptAway_) scan(false);
+    }
+
+    bool isEmpty() const { return tiles_.empty(); }
+    size_t getSize() const { return tiles_.size(); }
+    bool isKeptAwayFromPlayer() const { return keptAway_; }
+
+    // Sprite position for one random spawn tile; O(1)
+    sf::Vector2f pick(Random& random) const {
+        return toPosition(tiles_[random.below(static_cast<uint32_t>(tiles_.size()))]);
+    }
+
+    // A random spawn tile at least minDistance from point (the probe point's distance), if
+    // one turns up in a few draws; otherwise the last tile drawn
+    sf::Vector2f pickAwayFrom(Random& random, sf::Vector2f point, float minDistance) const {
+        sf::Vector2f position;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            position = pick(random);
+            sf::Vector2f away = position + probeOffset_ - point;
+            if (away.x * away.x + away.y * away.y >= minDistance * minDistance) break;
+        }
+        return position;
+    }
+
+    // count positions on distinct tiles (repeats only once every tile is used). Partial
+    // Fisher-Yates over the table, so O(count) however large the map. Appends to
+    // positions, any vector of sf::Vector2f.
+    template <typename Positions>
+    void pickWave(Random& random, int count, Positions& positions) {
+        const uint32_t size = static_cast<uint32_t>(tiles_.size());
+        if (size == 0) return;
+        for (int i = 0; i < count; ++i) {
+            uint32_t slot = static_cast<uint32_t>(i) % size;
+            std::swap(tiles_[slot], tiles_[slot + random.below(size - slot)]);
+            positions.push_back(toPosition(tiles_[slot]));
+        }
+    }
+
+private:
+    static uint32_t pack(int x, int y) { return static_cast<uint32_t>(x) | (static_cast<uint32_t>(y) << 16); }
+
+    static sf::Vector2i toTile(sf::Vector2f position) {
+        return sf::Vector2i(static_cast<int>(std::floor(position.x / SCALED_TILE_SIZE)),
+            static_cast<int>(std::floor(position.y / SCALED_TILE_SIZE)));
+    }
+
+    // Top left of a sprite whose probe point is the tile's centre
+    sf::Vector2f toPosition(int x, int y) const {
+        sf::Vector2f centre((x + 0.5f) * SCALED_TILE_SIZE, (y + 0.5f) * SCALED_TILE_SIZE);
+        return centre - probeOffset_;
+    }
+    sf::Vector2f toPosition(uint32_t tile) const { return toPosition(static_cast<int>(tile & 0xFFFF), static_cast<int>(tile >> 16)); }
+
+    std::vector<uint32_t> tiles_;   // x in the low 16 bits, y in the high
+    sf::Vector2f probeOffset_;
+    bool keptAway_ = true;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include "Counters.h"
+
+// Collects textured quads and draws them with one call per run of quads sharing a
+// texture. With every sprite in one atlas page that is a single draw call, however
+// many entities are on screen. Submission order is kept, so layering is unchanged.
+class SpriteBatch {
+public:
+    void draw(const sf::Sprite& sprite) {
+        draw(sprite.getTexture(), sprite.getTextureRect(), sprite.getTransform(), sprite.getColor());
+    }
+
+    void draw(const sf::Texture& texture, const sf::IntRect& rect, const sf::Transform& transform,
+        sf::Color color = sf::Color::White) {
+        if (batches_.empty() || batches_.back().texture != &texture) {
+            batches_.push_back({ &texture, vertices_.size(), 0 });
+        }
+
+        // Same corner layout as sf::Sprite, including flipped (negative size) rects
+        sf::Vector2f size(std::abs(static_cast<float>(rect.size.x)), std::abs(static_cast<float>(rect.size.y)));
+        sf::Vector2f texLeftTop(rect.position);
+        sf::Vector2f texRightBottom = texLeftTop + sf::Vector2f(rect.size);
+
+        sf::Vertex topLeft{ transform.transformPoint({ 0.f, 0.f }), color, texLeftTop };
+        sf::Vertex topRight{ transform.transformPoint({ size.x, 0.f }), color, { texRightBottom.x, texLeftTop.y } };
+        sf::Vertex bottomLeft{ transform.transformPoint({ 0.f, size.y }), color, { texLeftTop.x, texRightBottom.y } };
+        sf::Vertex bottomRight{ transform.transformPoint(size), color, texRightBottom };
+
+        vertices_.push_back(topLeft);
+        vertices_.push_back(topRight);
+        vertices_.push_back(bottomLeft);
+        vertices_.push_back(bottomLeft);
+        vertices_.push_back(topRight);
+        vertices_.push_back(bottomRight);
+        batches_.back().count += 6;
+    }
+
+    // Issue the draw calls and reset for the next frame (buffers keep their capacity)
+    void flush(sf::RenderTarget& target) {
+        const sf::Texture* bound = nullptr;
+        for (const Batch& batch : batches_) {
+            if (batch.texture != bound) {
+                COUNTER_ADD("texture switches", 1);
+                bound = batch.texture;
+            }
+            target.draw(&vertices_[batch.first], batch.count, sf::PrimitiveType::Triangles, sf::RenderStates(batch.texture));
+        }
+        COUNTER_ADD("draw calls", batches_.size());
+        lastDrawCalls_ = static_cast<unsigned int>(batches_.size());
+        lastQuads_ = static_cast<unsigned int>(vertices_.size() / 6);
+        vertices_.clear();
+        batches_.clear();
+    }
+
+    // Drop whatever is queued without drawing it
+    void clear() {
+        vertices_.clear();
+        batches_.clear();
+    }
+
+    unsigned int getLastDrawCalls() const { return lastDrawCalls_; }
+    unsigned int getLastQuadCount() const { return lastQuads_; }
+
+private:
+    struct Batch {
+        const sf::Texture* texture;
+        size_t first;
+        size_t count;
+    };
+
+    std::vector<sf::Vertex> vertices_;
+    std::vector<Batch> batches_;
+    unsigned int lastDrawCalls_ = 0;
+    unsigned int lastQuads_ = 0;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <SFML/System.hpp>
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <iostream>
+#include "ThreadPool.h"
+
+// Everything the game loads before its first frame, as a graph of jobs. Each job has
+//  - work:   runs on a worker thread; CPU only (decoding, parsing, building maps)
+//  - finish: runs on the GL thread afterwards (texture uploads, sprites, anything SFML
+//            graphics); kept short so the loading screen stays responsive
+// and starts once every job it depends on has finished both steps. Independent jobs run
+// in parallel.
+class StartupLoader {
+public:
+    using JobId = size_t;
+
+    explicit StartupLoader(ThreadPool& pool) : pool_(pool) {}
+
+    // Work still running references the caller's state, so wait for it
+    ~StartupLoader() {
+        for (auto& job : jobs_) {
+            if (job.running.valid()) job.running.wait();
+        }
+    }
+
+    StartupLoader(const StartupLoader&) = delete;
+    StartupLoader& operator=(const StartupLoader&) = delete;
+
+    // Either step may be empty. Returning false marks the job failed; jobs after it still run.
+    JobId add(const std::string& name, std::function<bool()> work, std::function<bool()> finish = {},
+        std::vector<JobId> after = {}) {
+        JobId id = jobs_.size();
+        jobs_.emplace_back();
+        Job& job = jobs_.back();
+        job.name = name;
+        job.work = std::move(work);
+        job.finish = std::move(finish);
+        job.waitingFor = after.size();
+        for (JobId dependency : after) {
+            jobs_[dependency].dependents.push_back(id);
+        }
+        return id;
+    }
+
+    // Call once every job has been added
+    void start() {
+        clock_.restart();
+        for (JobId id = 0; id < jobs_.size(); ++id) {
+            if (jobs_[id].waitingFor == 0) schedule(id);
+        }
+    }
+
+    // GL thread, once per loading-screen frame: runs the finish steps of jobs whose work is
+    // done, for up to timeSlice. True once every job is done.
+    bool update(sf::Time timeSlice) {
+        sf::Clock sliceClock;
+        while (sliceClock.getElapsedTime() < timeSlice) {
+            JobId id;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (workDone_.empty()) break;
+                id = workDone_.front();
+                workDone_.pop_front();
+            }
+
+            Job& job = jobs_[id];
+            if (job.running.valid()) job.running.get();
+            if (job.finish && !job.finish()) job.succeeded = false;
+            job.duration = clock_.getElapsedTime() - job.startTime;
+            job.done = true;
+            if (!job.succeeded) std::cerr << "Startup job failed: " << job.name << std::endl;
+            ++doneCount_;
+
+            for (JobId dependent : job.dependents) {
+                if (--jobs_[dependent].waitingFor == 0) schedule(dependent);
+            }
+        }
+        return isDone();
+    }
+
+    bool isDone() const { return doneCount_ == jobs_.size(); }
+    bool succeeded(JobId id) const { return jobs_[id].succeeded; }
+    float getProgress() const { return jobs_.empty() ? 1.f : static_cast<float>(doneCount_) / jobs_.size(); }
+    sf::Time getElapsedTime() const { return clock_.getElapsedTime(); }
+
+    // Name of a started but unfinished job, for the loading screen
+    std::string getStatus() const {
+        for (const auto& job : jobs_) {
+            if (job.scheduled && !job.done) return job.name;
+        }
+        return "";
+    }
+
+    // Time from each job's start to the end of its finish step
+    void printReport() const {
+        for (const auto& job : jobs_) {
+            std::cout << "  " << job.name << ": " << job.duration.asMilliseconds() << " ms" << (job.succeeded ? "" : " (failed)") << std::endl;
+        }
+    }
+
+private:
+    struct Job {
+        std::string name;
+        std::function<bool()> work;
+        std::function<bool()> finish;
+        std::vector<JobId> dependents;
+        size_t waitingFor = 0;
+        bool scheduled = false;
+        bool done = false;
+        bool succeeded = true;
+        sf::Time startTime;
+        sf::Time duration;
+        std::future<void> running;
+    };
+
+    void schedule(JobId id) {
+        Job& job = jobs_[id];
+        job.scheduled = true;
+        job.startTime = clock_.getElapsedTime();
+        if (!job.work) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            workDone_.push_back(id);
+            return;
+        }
+        // Only the worker touches job.work and job.succeeded until its id is queued
+        job.running = pool_.submit([this, id] {
+            Job& running = jobs_[id];
+            running.succeeded = running.work();
+            std::lock_guard<std::mutex> lock(mutex_);
+            workDone_.push_back(id);
+        });
+    }
+
+    ThreadPool& pool_;
+    std::deque<Job> jobs_;   // deque: jobs keep their address as more are added
+    std::mutex mutex_;
+    std::deque<JobId> workDone_;
+    size_t doneCount_ = 0;
+    sf::Clock clock_;
+};
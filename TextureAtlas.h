@@ -0,0 +1,401 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <charconv>
+#include "AssetPack.h"
+#include "RawTexture.h"
+#include "ThreadPool.h"
+
+// A sub-rectangle of one atlas page
+struct AtlasRegion {
+    const sf::Texture* page = nullptr;
+    sf::IntRect rect;
+
+    bool isValid() const { return page != nullptr; }
+};
+
+// Shelf packer: images are sorted tallest first and laid out left to right in rows
+// ("shelves"); a new page is opened when a shelf no longer fits.
+class RectPacker {
+public:
+    struct Placement {
+        int page = -1;
+        sf::Vector2i position;
+    };
+
+    RectPacker(unsigned int pageSize, int padding = 1) : pageSize_(static_cast<int>(pageSize)), padding_(padding) {}
+
+    // Returns one placement per input size (page -1 if it can never fit) and the height
+    // actually used on each page, so callers can trim the last page
+    std::vector<Placement> pack(const std::vector<sf::Vector2u>& sizes, std::vector<int>& pageHeights) const {
+        std::vector<size_t> order(sizes.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) {
+            if (sizes[a].y != sizes[b].y) return sizes[a].y > sizes[b].y;
+            return sizes[a].x > sizes[b].x;
+        });
+
+        std::vector<Placement> placements(sizes.size());
+        pageHeights.clear();
+
+        int page = -1;
+        int shelfX = 0, shelfY = 0, shelfHeight = 0;
+        for (size_t index : order) {
+            int width = static_cast<int>(sizes[index].x) + padding_;
+            int height = static_cast<int>(sizes[index].y) + padding_;
+            if (width > pageSize_ || height > pageSize_) continue;
+
+            if (page < 0) {
+                page = 0;
+                pageHeights.push_back(0);
+            }
+            if (shelfX + width > pageSize_) {
+                // Start a new shelf below the current one
+                shelfY += shelfHeight;
+                shelfX = 0;
+                shelfHeight = 0;
+            }
+            if (shelfY + height > pageSize_) {
+                // Page is full
+                ++page;
+                pageHeights.push_back(0);
+                shelfX = shelfY = shelfHeight = 0;
+            }
+
+            placements[index].page = page;
+            placements[index].position = sf::Vector2i(shelfX, shelfY);
+            shelfX += width;
+            shelfHeight = std::max(shelfHeight, height);
+            pageHeights[page] = std::max(pageHeights[page], shelfY + height);
+        }
+        return placements;
+    }
+
+private:
+    int pageSize_;
+    int padding_;
+};
+
+// Packs loose images into as few textures as possible. Works in two places:
+//  - at runtime: build() packs and uploads in one go;
+//  - offline: the AtlasPacker tool calls pack() and save(), writing pre-decoded pages plus
+//    a lookup table that loadPrebuilt() reads back without decoding any source image.
+// Sources are looked up afterwards by the same path they were added with.
+class TextureAtlas {
+public:
+    void addFile(const std::string& path) {
+        if (std::find(sources_.begin(), sources_.end(), path) == sources_.end()) {
+            sources_.push_back(path);
+        }
+    }
+
+    // Every .png directly inside the directory (as listed by the asset pack when it is open)
+    void addDirectory(const std::string& directory) {
+        std::vector<std::string> packed = assetPack().list(directory, ".png");
+        if (!packed.empty()) {
+            for (const auto& file : packed) {
+                addFile(file);
+            }
+            return;
+        }
+        if (!std::filesystem::is_directory(directory)) {
+            std::cerr << "Atlas directory not found: " << directory << std::endl;
+            return;
+        }
+        std::vector<std::string> files;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                files.push_back(entry.path().generic_string());
+            }
+        }
+        std::sort(files.begin(), files.end());
+        for (const auto& file : files) {
+            addFile(file);
+        }
+    }
+
+    // Decode every source and lay them out on page images (CPU only, no GL needed)
+    bool pack(unsigned int pageSize = 2048) {
+        // Decoding dominates, so it is spread over the worker pool
+        std::vector<DecodedImage> images(sources_.size());
+        std::vector<char> loaded(sources_.size());
+        workerPool().parallelFor(sources_.size(), [this, &images, &loaded](size_t i) {
+            loaded[i] = decodeImageAsset(sources_[i], images[i]);
+        });
+
+        std::vector<sf::Vector2u> sizes(sources_.size());
+        bool allLoaded = true;
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            if (!loaded[i]) {
+                std::cerr << "Failed to load atlas image: " << sources_[i] << std::endl;
+                allLoaded = false;
+            }
+            sizes[i] = images[i].size;
+        }
+
+        std::vector<int> pageHeights;
+        std::vector<RectPacker::Placement> placements = RectPacker(pageSize).pack(sizes, pageHeights);
+
+        pageImages_.clear();
+        decodedPages_.clear();
+        for (int height : pageHeights) {
+            pageImages_.emplace_back(sf::Vector2u(pageSize, static_cast<unsigned int>(height)), sf::Color::Transparent);
+        }
+
+        entries_.clear();
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            if (sizes[i].x == 0 || sizes[i].y == 0) continue;
+            if (placements[i].page < 0) {
+                std::cerr << "Image too large for atlas page: " << sources_[i] << std::endl;
+                allLoaded = false;
+                continue;
+            }
+            sf::Vector2u destination(placements[i].position);
+            if (!pageImages_[placements[i].page].copy(images[i].toImage(), destination)) {
+                allLoaded = false;
+                continue;
+            }
+            entries_[sources_[i]] = Entry{ placements[i].page, sf::IntRect(placements[i].position, sf::Vector2i(sizes[i])) };
+        }
+        return allLoaded;
+    }
+
+    // Turn packed or prebuilt page images into textures; needs a GL context
+    bool upload() {
+        bool allUploaded = true;
+        pages_.clear();
+        for (const auto& pageImage : pageImages_) {
+            auto page = std::make_unique<sf::Texture>();
+            if (!page->loadFromImage(pageImage)) {
+                std::cerr << "Failed to upload atlas page" << std::endl;
+                allUploaded = false;
+            }
+            pages_.push_back(std::move(page));
+        }
+        for (const auto& decodedPage : decodedPages_) {
+            auto page = std::make_unique<sf::Texture>();
+            if (!uploadDecodedImage(*page, decodedPage)) {
+                std::cerr << "Failed to upload atlas page" << std::endl;
+                allUploaded = false;
+            }
+            pages_.push_back(std::move(page));
+        }
+        pageImages_.clear();
+        decodedPages_.clear();
+        resolveRegions();
+        return allUploaded;
+    }
+
+    // For headless runs: regions get their rects but point at empty page textures, so
+    // sprites and their bounds work without a GL context. Nothing drawn from them shows.
+    void layoutWithoutTextures() {
+        size_t pageCount = pageImages_.size() + decodedPages_.size();
+        pages_.clear();
+        for (size_t i = 0; i < pageCount; ++i) {
+            pages_.push_back(std::make_unique<sf::Texture>());
+        }
+        pageImages_.clear();
+        decodedPages_.clear();
+        resolveRegions();
+    }
+
+    bool build(unsigned int pageSize = 2048) {
+        pageSize = std::min(pageSize, sf::Texture::getMaximumSize());
+        bool packed = pack(pageSize);
+        bool uploaded = upload();
+        std::cout << "Packed " << regions_.size() << " images into " << pages_.size() << " atlas page(s)" << std::endl;
+        return packed && uploaded;
+    }
+
+    // Write <table>, plus one <table stem>_<page> image per page next to it. Pages are
+    // pre-decoded (.avtx) so the game uploads them without decoding a PNG; pass false to
+    // write PNGs instead, e.g. to look at them.
+    bool save(const std::string& tablePath, bool preDecoded = true) const {
+        std::filesystem::path table(tablePath);
+        if (table.has_parent_path()) {
+            std::filesystem::create_directories(table.parent_path());
+        }
+
+        std::ofstream file(tablePath);
+        if (!file) {
+            std::cerr << "Failed to write atlas table: " << tablePath << std::endl;
+            return false;
+        }
+        file << "# AshVale texture atlas: page <index> <image>, region <page> <x> <y> <w> <h> <source>\n";
+        for (size_t i = 0; i < pageImages_.size(); ++i) {
+            std::string pageFile = table.stem().string() + "_" + std::to_string(i) + (preDecoded ? RAW_TEXTURE_EXTENSION : ".png");
+            std::filesystem::path pagePath = table.parent_path() / pageFile;
+            bool saved = preDecoded ? saveRawTexture(pageImages_[i], pagePath.string()) : pageImages_[i].saveToFile(pagePath);
+            if (!saved) {
+                std::cerr << "Failed to write atlas page: " << pageFile << std::endl;
+                return false;
+            }
+            file << "page\t" << i << "\t" << pageFile << "\n";
+        }
+        for (const auto& source : sources_) {
+            auto it = entries_.find(source);
+            if (it == entries_.end()) continue;
+            const sf::IntRect& rect = it->second.rect;
+            file << "region\t" << it->second.page << "\t" << rect.position.x << "\t" << rect.position.y << "\t"
+                << rect.size.x << "\t" << rect.size.y << "\t" << source << "\n";
+        }
+        return static_cast<bool>(file);
+    }
+
+    // Read the lookup table written by save() and decode its pages, ready for upload()
+    // (CPU only). Fails, changing nothing, if the table is missing or stale, i.e. does
+    // not cover every source added so far, or cannot be parsed.
+    bool readPrebuilt(const std::string& tablePath) {
+        std::string table;
+        if (!readTextAsset(tablePath, table)) return false;
+        std::istringstream file(table);
+
+        std::vector<std::string> pageFiles;
+        std::unordered_map<std::string, Entry> entries;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::vector<std::string> fields;
+            size_t start = 0;
+            while (true) {
+                size_t tab = line.find('\t', start);
+                fields.push_back(line.substr(start, tab - start));
+                if (tab == std::string::npos) break;
+                start = tab + 1;
+            }
+            bool valid = true;
+            if (fields[0] == "page" && fields.size() == 3) {
+                size_t index = 0;
+                valid = parseField(fields[1], index) && index < MAX_PREBUILT_PAGES;
+                if (valid) {
+                    if (pageFiles.size() <= index) pageFiles.resize(index + 1);
+                    pageFiles[index] = fields[2];
+                }
+            }
+            else if (fields[0] == "region" && fields.size() == 7) {
+                Entry entry;
+                sf::Vector2i position, size;
+                valid = parseField(fields[1], entry.page) && parseField(fields[2], position.x) && parseField(fields[3], position.y)
+                    && parseField(fields[4], size.x) && parseField(fields[5], size.y) && entry.page >= 0;
+                if (valid) {
+                    entry.rect = sf::IntRect(position, size);
+                    entries[fields[6]] = entry;
+                }
+            }
+            if (!valid) {
+                std::cout << "Prebuilt atlas " << tablePath << " has a bad line, repacking: " << line << std::endl;
+                return false;
+            }
+        }
+        for (const auto& [source, entry] : entries) {
+            if (static_cast<size_t>(entry.page) >= pageFiles.size()) {
+                std::cout << "Prebuilt atlas " << tablePath << " puts " << source << " on a missing page, repacking" << std::endl;
+                return false;
+            }
+        }
+
+        for (const auto& source : sources_) {
+            if (entries.find(source) == entries.end()) {
+                std::cout << "Prebuilt atlas " << tablePath << " is missing " << source << ", repacking" << std::endl;
+                return false;
+            }
+        }
+
+        std::filesystem::path directory = std::filesystem::path(tablePath).parent_path();
+        std::vector<DecodedImage> pageImages(pageFiles.size());
+        std::vector<char> decoded(pageFiles.size());
+        workerPool().parallelFor(pageFiles.size(), [&](size_t i) {
+            decoded[i] = decodeImageAsset((directory / pageFiles[i]).generic_string(), pageImages[i]);
+        });
+        for (size_t i = 0; i < pageFiles.size(); ++i) {
+            if (!decoded[i]) {
+                std::cerr << "Failed to load atlas page: " << pageFiles[i] << std::endl;
+                return false;
+            }
+        }
+
+        pageImages_.clear();
+        decodedPages_ = std::move(pageImages);
+        entries_ = std::move(entries);
+        std::cout << "Read prebuilt atlas " << tablePath << " (" << decodedPages_.size() << " page(s))" << std::endl;
+        return true;
+    }
+
+    bool loadPrebuilt(const std::string& tablePath) {
+        return readPrebuilt(tablePath) && upload();
+    }
+
+    // CPU half of loadOrBuild(), safe on a worker thread: the prebuilt atlas when it is
+    // current, otherwise the sources packed now. Follow with upload() on the GL thread.
+    bool prepare(const std::string& tablePath, unsigned int pageSize = 2048) {
+        if (readPrebuilt(tablePath)) return true;
+        bool packed = pack(pageSize);
+        std::cout << "Packed " << entries_.size() << " images into " << pageImages_.size() << " atlas page(s)" << std::endl;
+        return packed;
+    }
+
+    // Use the prebuilt atlas when it is current, otherwise pack at startup
+    bool loadOrBuild(const std::string& tablePath, unsigned int pageSize = 2048) {
+        bool prepared = prepare(tablePath, std::min(pageSize, sf::Texture::getMaximumSize()));
+        bool uploaded = upload();
+        return prepared && uploaded;
+    }
+
+    AtlasRegion find(const std::string& path) const {
+        auto it = regions_.find(path);
+        if (it == regions_.end()) return AtlasRegion();
+        return it->second;
+    }
+
+    // Map a sub-rectangle of a source image (e.g. one tile of a tilesheet) into atlas coordinates
+    AtlasRegion find(const std::string& path, const sf::IntRect& subRect) const {
+        AtlasRegion region = find(path);
+        if (region.isValid()) {
+            region.rect = sf::IntRect(region.rect.position + subRect.position, subRect.size);
+        }
+        return region;
+    }
+
+    size_t getPageCount() const { return pages_.empty() ? pageImages_.size() + decodedPages_.size() : pages_.size(); }
+    size_t getRegionCount() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        int page = 0;
+        sf::IntRect rect;
+    };
+
+    static constexpr size_t MAX_PREBUILT_PAGES = 256;  // A table asking for more is corrupt
+
+    // A whole table field as a number; false for anything else
+    template <typename T>
+    static bool parseField(const std::string& text, T& value) {
+        const char* end = text.data() + text.size();
+        auto [parsedEnd, error] = std::from_chars(text.data(), end, value);
+        return error == std::errc() && parsedEnd == end;
+    }
+
+    void resolveRegions() {
+        regions_.clear();
+        for (const auto& [source, entry] : entries_) {
+            if (entry.page < 0 || static_cast<size_t>(entry.page) >= pages_.size()) continue;
+            regions_[source] = AtlasRegion{ pages_[entry.page].get(), entry.rect };
+        }
+    }
+
+    std::vector<std::string> sources_;
+    std::vector<sf::Image> pageImages_;                 // Only held between pack() and upload()/save()
+    std::vector<DecodedImage> decodedPages_;            // Only held between readPrebuilt() and upload()
+    std::unordered_map<std::string, Entry> entries_;    // Source path -> page and rect
+    std::vector<std::unique_ptr<sf::Texture>> pages_;   // unique_ptr keeps page addresses stable
+    std::unordered_map<std::string, AtlasRegion> regions_;
+};
@@ -0,0 +1,68 @@
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include "RawTexture.h"
+
+// Offline image converter. Writes a pre-decoded .avtx next to each source image, which
+// loads with a memcpy (or a fast LZ pass) and a single texture upload instead of a PNG decode.
+//
+//   TextureConverter a.png dir/ ...        convert files, and every .png directly in directories
+//   --raw                                  store pixels uncompressed (largest, fastest)
+
+bool convert(const std::filesystem::path& source, bool compress) {
+    sf::Image image;
+    if (!image.loadFromFile(source)) {
+        std::cerr << "Failed to load image: " << source.generic_string() << std::endl;
+        return false;
+    }
+    std::filesystem::path output = source;
+    output.replace_extension(RAW_TEXTURE_EXTENSION);
+    if (!saveRawTexture(image, output.string(), compress)) {
+        std::cerr << "Failed to write: " << output.generic_string() << std::endl;
+        return false;
+    }
+
+    std::cout << source.generic_string() << " -> " << output.generic_string() << " (" << image.getSize().x << "x"
+        << image.getSize().y << ", " << std::filesystem::file_size(source) << " -> " << std::filesystem::file_size(output)
+        << " bytes)" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool compress = true;
+    std::vector<std::filesystem::path> sources;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--raw") {
+            compress = false;
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: TextureConverter [--raw] [image.png | directory]..." << std::endl;
+            return 0;
+        }
+        else if (std::filesystem::is_directory(arg)) {
+            for (const auto& entry : std::filesystem::directory_iterator(arg)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".png") {
+                    sources.push_back(entry.path());
+                }
+            }
+        }
+        else {
+            sources.push_back(arg);
+        }
+    }
+
+    if (sources.empty()) {
+        std::cout << "Usage: TextureConverter [--raw] [image.png | directory]..." << std::endl;
+        return 1;
+    }
+
+    bool allConverted = true;
+    for (const auto& source : sources) {
+        allConverted = convert(source, compress) && allConverted;
+    }
+    return allConverted ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+
+// Fixed set of worker threads for CPU-side loading work (image decoding, map building).
+// Nothing that touches GL or the window may run on it.
+class ThreadPool {
+public:
+    // One thread is left for the main (GL) thread
+    static unsigned int defaultThreadCount() {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+    explicit ThreadPool(unsigned int threadCount = defaultThreadCount()) {
+        for (unsigned int i = 0; i < std::max(1u, threadCount); ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t getThreadCount() const { return workers_.size(); }
+
+    template <typename Function>
+    auto submit(Function function) -> std::future<std::invoke_result_t<Function>> {
+        using Result = std::invoke_result_t<Function>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(function));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([task] { (*task)(); });
+        }
+        wake_.notify_one();
+        return result;
+    }
+
+    // Runs function(i) for every i in [0, count) and returns once all are done. The calling
+    // thread works through the range too, so this is safe to call from a worker.
+    template <typename Function>
+    void parallelFor(size_t count, Function function) {
+        if (count == 0) return;
+
+        struct Progress {
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> done{ 0 };
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto progress = std::make_shared<Progress>();
+
+        // A helper that starts after every index was claimed returns without touching
+        // function, so it is fine for it to outlive this call
+        auto work = [progress, count, &function] {
+            for (size_t i = progress->next++; i < count; i = progress->next++) {
+                function(i);
+                if (++progress->done == count) {
+                    std::lock_guard<std::mutex> lock(progress->mutex);
+                    progress->finished.notify_all();
+                }
+            }
+        };
+
+        size_t helpers = std::min(count - 1, workers_.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t i = 0; i < helpers; ++i) {
+                tasks_.emplace_back(work);
+            }
+        }
+        wake_.notify_all();
+
+        work();
+        std::unique_lock<std::mutex> lock(progress->mutex);
+        progress->finished.wait(lock, [&progress, count] { return progress->done == count; });
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return; // Stopping and drained
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+// Shared by the loaders; started on first use
+inline ThreadPool& workerPool() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -7,132 +7,27 @@
 #include <map>
 #include <optional>
 #include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
-const int TILE_SIZE = 16; // Base size of each tile in pixels
-const int SCALE_FACTOR = 3; // Scale factor for map window only
-const int SCALED_TILE_SIZE = TILE_SIZE * SCALE_FACTOR;
-const int MAP_WIDTH_PIXELS = 1027; // Width of the map in pixels
-const int MAP_HEIGHT_PIXELS = 768; // Height of the map in pixels
-const int MAP_WIDTH = MAP_WIDTH_PIXELS / TILE_SIZE; // Width of the map (in tiles)
-const int MAP_HEIGHT = MAP_HEIGHT_PIXELS / TILE_SIZE; // Height of the map (in tiles)
+#include "MapManager.h"
 
-class Tile {
-public:
-    Tile() : textureRect(sf::IntRect({ 0, 0 }, { TILE_SIZE, TILE_SIZE })), isPlaced(false), isPassable(true) {}
-    Tile(const sf::IntRect& rect) : textureRect(rect), isPlaced(true), isPassable(true) {}
-
-    const sf::IntRect& getTextureRect() const { return textureRect; }
-    void setTextureRect(const sf::IntRect& rect) {
-        textureRect = rect;
-        isPlaced = true;
-    }
-    bool hasBeenPlaced() const { return isPlaced; }
-
-    bool isPassableByPlayer() const { return isPassable; }
-    void setPassable(bool passable) { isPassable = passable; }
-
-private:
-    sf::IntRect textureRect;
-    bool isPlaced;
-    bool isPassable;
-};
-
-class TileMap {
-public:
-    TileMap(int width, int height) {
-        map.resize(height, std::vector<Tile>(width));
-    }
-
-    void draw(sf::RenderWindow& window, const sf::Texture& tilesheet) {
-        for (int y = 0; y < MAP_HEIGHT; ++y) {
-            for (int x = 0; x < MAP_WIDTH; ++x) {
-                const auto& tile = map[y][x];
-                if (tile.hasBeenPlaced()) {
-                    const auto& tileRect = tile.getTextureRect();
-                    sf::Sprite sprite(tilesheet);
-                    sprite.setTextureRect(tileRect);
-                    sprite.setPosition(sf::Vector2f(static_cast<float>(x * SCALED_TILE_SIZE),
-                        static_cast<float>(y * SCALED_TILE_SIZE)));
-                    sprite.setScale(sf::Vector2f(SCALE_FACTOR, SCALE_FACTOR));
-
-                    // Draw non-passable tiles with a slight red tint
-                    if (!tile.isPassableByPlayer()) {
-                        sprite.setColor(sf::Color(255, 200, 200, 255));
-                    }
-
-                    window.draw(sprite);
-                }
-            }
-        }
-    }
-
-    void setTile(int x, int y, const sf::IntRect& textureRect, bool passable = true) {
-        if (x >= 0 && x < MAP_WIDTH && y >= 0 && y < MAP_HEIGHT) {
-            map[y][x].setTextureRect(textureRect);
-            map[y][x].setPassable(passable);
-        }
-    }
-
-    void save(const std::string& filename) {
-        std::ofstream file(filename, std::ios::binary);
-        if (file) {
-            for (const auto& row : map) {
-                for (const auto& tile : row) {
-                    bool placed = tile.hasBeenPlaced();
-                    file.write(reinterpret_cast<const char*>(&placed), sizeof(placed));
-                    if (placed) {
-                        const auto& rect = tile.getTextureRect();
-                        file.write(reinterpret_cast<const char*>(&rect.position.x), sizeof(rect.position.x));
-                        file.write(reinterpret_cast<const char*>(&rect.position.y), sizeof(rect.position.y));
-                        file.write(reinterpret_cast<const char*>(&rect.size.x), sizeof(rect.size.x));
-                        file.write(reinterpret_cast<const char*>(&rect.size.y), sizeof(rect.size.y));
-
-                        // Save passable property
-                        bool passable = tile.isPassableByPlayer();
-                        file.write(reinterpret_cast<const char*>(&passable), sizeof(passable));
-                    }
-                }
-            }
-        }
-    }
-
-    void load(const std::string& filename) {
-        std::ifstream file(filename, std::ios::binary);
-        if (file) {
-            for (auto& row : map) {
-                for (auto& tile : row) {
-                    bool placed;
-                    file.read(reinterpret_cast<char*>(&placed), sizeof(placed));
-                    if (placed) {
-                        sf::IntRect rect;
-                        file.read(reinterpret_cast<char*>(&rect.position.x), sizeof(rect.position.x));
-                        file.read(reinterpret_cast<char*>(&rect.position.y), sizeof(rect.position.y));
-                        file.read(reinterpret_cast<char*>(&rect.size.x), sizeof(rect.size.x));
-                        file.read(reinterpret_cast<char*>(&rect.size.y), sizeof(rect.size.y));
-                        tile.setTextureRect(rect);
-
-                        // Load passable property if it exists in the file
-                        bool passable = true;
-                        if (file.peek() != EOF) {
-                            file.read(reinterpret_cast<char*>(&passable), sizeof(passable));
-                            tile.setPassable(passable);
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-private:
-    std::vector<std::vector<Tile>> map;
-};
+const int MAP_WINDOW_WIDTH = 1027; // Width of the map window in pixels
+const int MAP_WINDOW_HEIGHT = 768; // Height of the map window in pixels
+const float SCROLL_SPEED = 12.f; // Pixels per frame when scrolling the map view
+const int STREAMED_MAP_TILES = 128 * 128; // Maps larger than this are saved chunked so the game streams them
 
 class TileMapEditor {
 public:
-    TileMapEditor()
-        : mapWindow_(sf::VideoMode(sf::Vector2u(MAP_WIDTH_PIXELS, MAP_HEIGHT_PIXELS)), "Map Editor")
+    // New maps are width x height tiles; loaded maps keep the size stored in their file
+    TileMapEditor(int width, int height)
+        : mapWindow_(sf::VideoMode(sf::Vector2u(MAP_WINDOW_WIDTH, MAP_WINDOW_HEIGHT)), "Map Editor")
         , tilesheetWindow_(sf::VideoMode(sf::Vector2u(512, 512)), "Tilesheet Selector")
-        , tileMap_(MAP_WIDTH, MAP_HEIGHT)
+        , tileMap_(width, height)
+        , newMapWidth_(width)
+        , newMapHeight_(height)
+        , mapView_(mapWindow_.getDefaultView())
         , selectedTileRect_({ 0, 0 }, { TILE_SIZE, TILE_SIZE })
         , showGrid_(true)
         , currentMapNumber_(1)
@@ -164,6 +59,7 @@ public:
         std::cout << "Ctrl + L: Load last saved map" << std::endl;
         std::cout << "Ctrl + N: New blank map" << std::endl;
         std::cout << "G: Toggle grid" << std::endl;
+        std::cout << "Arrow keys: Scroll the map" << std::endl;
         std::cout << "P: Toggle passability for selected tile" << std::endl;
         std::cout << "Type a number and press Enter to load that map (e.g., '18' loads map_18.dat)" << std::endl;
     }
@@ -171,9 +67,15 @@ public:
     void loadMap(int mapNumber) {
         std::string filename = "maps/map_" + std::to_string(mapNumber) + ".dat";
         if (std::filesystem::exists(filename)) {
-            tileMap_.load(filename);
+            // Mapped copy-on-write: only the pages that get painted on are copied
+            TileMap map;
+            if (!map.load(filename, MappedFile::Mode::CopyOnWrite)) {
+                std::cout << "Failed to load map: " << filename << std::endl;
+                return;
+            }
+            tileMap_ = std::move(map);
             currentMapNumber_ = mapNumber;
-            std::cout << "Loaded map: " << filename << std::endl;
+            std::cout << "Loaded map: " << filename << " (" << tileMap_.getWidth() << "x" << tileMap_.getHeight() << " tiles)" << std::endl;
         }
         else {
             std::cout << "Map " << filename << " does not exist!" << std::endl;
@@ -210,9 +112,10 @@ private:
             else if (event->is<sf::Event::MouseButtonPressed>()) {
                 const auto& mouseEvent = *event->getIf<sf::Event::MouseButtonPressed>();
                 if (mouseEvent.button == sf::Mouse::Button::Left) {
-                    // Calculate tile position based on scaled tile size
-                    int tileX = mouseEvent.position.x / (TILE_SIZE * SCALE_FACTOR);
-                    int tileY = mouseEvent.position.y / (TILE_SIZE * SCALE_FACTOR);
+                    // Calculate tile position based on scaled tile size, in world coordinates
+                    sf::Vector2f worldPosition = mapWindow_.mapPixelToCoords(mouseEvent.position, mapView_);
+                    int tileX = static_cast<int>(std::floor(worldPosition.x / SCALED_TILE_SIZE));
+                    int tileY = static_cast<int>(std::floor(worldPosition.y / SCALED_TILE_SIZE));
                     tileMap_.setTile(tileX, tileY, selectedTileRect_, isPassable_);
                 }
             }
@@ -228,9 +131,16 @@ private:
                 else if (keyEvent.code == sf::Keyboard::Key::S && keyEvent.control) {
                     // Save with numbered filename
                     std::string filename = "maps/map_" + std::to_string(currentMapNumber_) + ".dat";
-                    tileMap_.save(filename);
-                    std::cout << "Map saved as: " << filename << std::endl;
-                    currentMapNumber_++;
+                    bool chunked = tileMap_.getWidth() * tileMap_.getHeight() > STREAMED_MAP_TILES;
+                    bool saved = chunked ? tileMap_.saveChunked(filename) : tileMap_.save(filename);
+                    if (!saved) {
+                        std::cout << "Failed to save map: " << filename << std::endl;
+                    }
+                    else {
+                        std::cout << "Map saved as: " << filename << " (" << tileMap_.getWidth() << "x" << tileMap_.getHeight() << " tiles"
+                            << (chunked ? ", chunked" : "") << ")" << std::endl;
+                        currentMapNumber_++;
+                    }
                 }
                 else if (keyEvent.code == sf::Keyboard::Key::L && keyEvent.control) {
                     // Load the last saved map
@@ -240,8 +150,9 @@ private:
                 }
                 // Add N key to create a new blank map
                 else if (keyEvent.code == sf::Keyboard::Key::N && keyEvent.control) {
-                    tileMap_ = TileMap(MAP_WIDTH, MAP_HEIGHT);
-                    std::cout << "Created new blank map" << std::endl;
+                    tileMap_ = TileMap(newMapWidth_, newMapHeight_);
+                    mapView_ = mapWindow_.getDefaultView();
+                    std::cout << "Created new blank map (" << newMapWidth_ << "x" << newMapHeight_ << " tiles)" << std::endl;
                 }
                 // Load specific map number (Ctrl + number)
                 else if (keyEvent.control && keyEvent.code >= sf::Keyboard::Key::Num0 && keyEvent.code <= sf::Keyboard::Key::Num9) {
@@ -269,16 +180,38 @@ private:
     }
 
     void update() {
-        // Update logic here if needed
+        // Scroll the map view, keeping it over the map
+        if (!mapWindow_.hasFocus()) return;
+
+        sf::Vector2f scroll;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) scroll.x -= SCROLL_SPEED;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) scroll.x += SCROLL_SPEED;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) scroll.y -= SCROLL_SPEED;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) scroll.y += SCROLL_SPEED;
+
+        sf::Vector2f halfSize = mapView_.getSize() / 2.f;
+        sf::Vector2f mapSize = tileMap_.getPixelSize();
+        sf::Vector2f center = mapView_.getCenter() + scroll;
+        center.x = std::clamp(center.x, halfSize.x, std::max(halfSize.x, mapSize.x - halfSize.x));
+        center.y = std::clamp(center.y, halfSize.y, std::max(halfSize.y, mapSize.y - halfSize.y));
+        mapView_.setCenter(center);
     }
 
     void render() {
         // Render map window
         mapWindow_.clear(sf::Color(50, 50, 50));
-        tileMap_.draw(mapWindow_, tilesheet_);
+        mapWindow_.setView(mapView_);
+        sf::FloatRect visibleArea(mapView_.getCenter() - mapView_.getSize() / 2.f, mapView_.getSize());
+
+        // Draw non-passable tiles with a slight red tint
+        AtlasRegion tilesheet{ &tilesheet_, sf::IntRect({ 0, 0 }, sf::Vector2i(tilesheet_.getSize())) };
+        tileMap_.draw(tileBatch_, tilesheet, visibleArea, sf::Color(255, 200, 200, 255));
+        tileBatch_.flush(mapWindow_);
+
         if (showGrid_) {
             drawGrid(mapWindow_);
         }
+        mapWindow_.setView(mapWindow_.getDefaultView());
         mapWindow_.display();
 
         // Render tilesheet window (no scaling)
@@ -301,16 +234,17 @@ private:
     }
 
     void drawGrid(sf::RenderWindow& window) {
-        sf::RectangleShape line(sf::Vector2f(1, window.getSize().y));
+        sf::Vector2f mapSize = tileMap_.getPixelSize();
+        sf::RectangleShape line(sf::Vector2f(1, mapSize.y));
         line.setFillColor(sf::Color(100, 100, 100, 100));
 
-        for (unsigned int x = 0; x <= MAP_WIDTH; ++x) {
+        for (int x = 0; x <= tileMap_.getWidth(); ++x) {
             line.setPosition(sf::Vector2f(static_cast<float>(x * SCALED_TILE_SIZE), 0));
             window.draw(line);
         }
 
-        line.setSize(sf::Vector2f(window.getSize().x, 1));
-        for (unsigned int y = 0; y <= MAP_HEIGHT; ++y) {
+        line.setSize(sf::Vector2f(mapSize.x, 1));
+        for (int y = 0; y <= tileMap_.getHeight(); ++y) {
             line.setPosition(sf::Vector2f(0, static_cast<float>(y * SCALED_TILE_SIZE)));
             window.draw(line);
         }
@@ -319,6 +253,10 @@ private:
     sf::RenderWindow mapWindow_;
     sf::RenderWindow tilesheetWindow_;
     TileMap tileMap_;
+    int newMapWidth_;
+    int newMapHeight_;
+    sf::View mapView_;
+    SpriteBatch tileBatch_;
     sf::Texture tilesheet_;
     sf::IntRect selectedTileRect_;
     bool showGrid_;
@@ -326,8 +264,16 @@ private:
     bool isPassable_;
 };
 
-int main() {
-    TileMapEditor editor;
+// Usage: TileMapEditor [width height]   size in tiles of new maps (default 80x45)
+int main(int argc, char* argv[]) {
+    int width = LEGACY_MAP_WIDTH;
+    int height = LEGACY_MAP_HEIGHT;
+    if (argc >= 3) {
+        width = std::clamp(std::atoi(argv[1]), 1, MAX_MAP_DIMENSION);
+        height = std::clamp(std::atoi(argv[2]), 1, MAX_MAP_DIMENSION);
+    }
+
+    TileMapEditor editor(width, height);
     editor.run();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <functional>
+
+// The simulation advances in fixed ticks; every gameplay timer counts ticks instead of
+// reading a wall clock, so checking a timer never touches the OS.
+const int SIM_TICK_RATE = 60; // Simulation ticks per second
+
+inline uint32_t secondsToTicks(float seconds) {
+    long ticks = std::lround(seconds * SIM_TICK_RATE);
+    return ticks < 1 ? 1u : static_cast<uint32_t>(ticks);
+}
+
+// Hierarchical timer wheel (4 levels x 64 slots). Timers are bucketed by expiry tick;
+// far-off timers sit in the coarser levels and cascade down as the wheel turns, so
+// scheduling, cancelling and advancing are all O(1) per timer.
+class TimerWheel {
+public:
+    using TimerId = uint64_t; // 0 is never a valid id
+
+    TimerWheel() {
+        for (auto& head : slots_) head = NONE;
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Fire `callback` after `delayTicks` ticks (at least one). The callback may be empty,
+    // in which case the timer is only a state flip observed through isPending().
+    TimerId schedule(uint32_t delayTicks, std::function<void()> callback = {}) {
+        uint32_t index = allocateNode();
+        Node& node = nodes_[index];
+        node.expiry = now_ + (delayTicks < 1 ? 1 : delayTicks);
+        node.callback = std::move(callback);
+        node.active = true;
+        link(index);
+        return makeId(index, node.generation);
+    }
+
+    void cancel(TimerId id) {
+        uint32_t index;
+        if (!resolve(id, index)) return;
+        unlink(index);
+        releaseNode(index);
+    }
+
+    bool isPending(TimerId id) const {
+        uint32_t index;
+        return resolve(id, index);
+    }
+
+    // Ticks left before the timer fires, 0 if it already fired or was cancelled
+    uint32_t remaining(TimerId id) const {
+        uint32_t index;
+        if (!resolve(id, index)) return 0;
+        return static_cast<uint32_t>(nodes_[index].expiry - now_);
+    }
+
+    // Advance the wheel by one simulation tick and fire everything that expires on it
+    void advance() {
+        ++now_;
+
+        // When the lowest level wraps, pull the next block of timers down from above
+        if ((now_ & SLOT_MASK) == 0) {
+            for (int level = 1; level < LEVELS; ++level) {
+                uint32_t slot = static_cast<uint32_t>((now_ >> (level * SLOT_BITS)) & SLOT_MASK);
+                cascade(level, slot);
+                if (slot != 0) break;
+            }
+        }
+
+        uint32_t& head = slots_[now_ & SLOT_MASK];
+        while (head != NONE) {
+            uint32_t index = head;
+            unlink(index);
+            // Move the callback out first: it may schedule new timers and grow the pool
+            std::function<void()> callback = std::move(nodes_[index].callback);
+            releaseNode(index);
+            if (callback) callback();
+        }
+    }
+
+    uint64_t now() const { return now_; }
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+    static const int LEVELS = 4;
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t expiry = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t slot = NONE;
+        uint32_t generation = 1;
+        bool active = false;
+        std::function<void()> callback;
+    };
+
+    static TimerId makeId(uint32_t index, uint32_t generation) {
+        return (static_cast<uint64_t>(generation) << 32) | index;
+    }
+
+    bool resolve(TimerId id, uint32_t& index) const {
+        index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        uint32_t generation = static_cast<uint32_t>(id >> 32);
+        return generation != 0 && index < nodes_.size() &&
+            nodes_[index].active && nodes_[index].generation == generation;
+    }
+
+    uint32_t allocateNode() {
+        if (freeHead_ != NONE) {
+            uint32_t index = freeHead_;
+            freeHead_ = nodes_[index].next;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void releaseNode(uint32_t index) {
+        Node& node = nodes_[index];
+        node.active = false;
+        node.callback = nullptr;
+        // Bump the generation so stale ids held by entities stop matching
+        if (++node.generation == 0) node.generation = 1;
+        node.next = freeHead_;
+        freeHead_ = index;
+    }
+
+    // Pick the level whose span covers the distance to expiry, then the slot inside it
+    void link(uint32_t index) {
+        Node& node = nodes_[index];
+        uint64_t delta = node.expiry > now_ ? node.expiry - now_ : 0;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1ull << ((level + 1) * SLOT_BITS))) {
+            ++level;
+        }
+        uint64_t expiry = node.expiry;
+        if (level == LEVELS - 1 && delta >= (1ull << (LEVELS * SLOT_BITS))) {
+            // Too far out for the wheel: park it in the furthest slot and re-bucket later
+            expiry = now_ + (1ull << (LEVELS * SLOT_BITS)) - 1;
+        }
+        uint32_t slot = static_cast<uint32_t>(level * SLOTS + ((expiry >> (level * SLOT_BITS)) & SLOT_MASK));
+
+        node.slot = slot;
+        node.prev = NONE;
+        node.next = slots_[slot];
+        if (node.next != NONE) nodes_[node.next].prev = index;
+        slots_[slot] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != NONE) nodes_[node.prev].next = node.next;
+        else slots_[node.slot] = node.next;
+        if (node.next != NONE) nodes_[node.next].prev = node.prev;
+        node.prev = node.next = NONE;
+        node.slot = NONE;
+    }
+
+    void cascade(int level, uint32_t slot) {
+        uint32_t index = slots_[level * SLOTS + slot];
+        slots_[level * SLOTS + slot] = NONE;
+        while (index != NONE) {
+            uint32_t next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    std::vector<Node> nodes_;
+    uint32_t slots_[LEVELS * SLOTS];
+    uint32_t freeHead_ = NONE;
+    uint64_t now_ = 0;
+};
+
+// Entity-owned timer on a TimerWheel. Stands in for the old "sf::Clock + getElapsedTime()
+// > duration" idiom: start() arms it, and it reports finished once the wheel has fired it.
+// Destroying the owner cancels any pending expiry.
+class Countdown {
+public:
+    explicit Countdown(TimerWheel& wheel) : wheel_(&wheel) {}
+    ~Countdown() { stop(); }
+
+    Countdown(const Countdown&) = delete;
+    Countdown& operator=(const Countdown&) = delete;
+
+    Countdown(Countdown&& other) noexcept : wheel_(other.wheel_), id_(other.id_) {
+        other.id_ = 0;
+    }
+    Countdown& operator=(Countdown&& other) noexcept {
+        if (this != &other) {
+            stop();
+            wheel_ = other.wheel_;
+            id_ = other.id_;
+            other.id_ = 0;
+        }
+        return *this;
+    }
+
+    void start(float seconds, std::function<void()> onExpire = {}) {
+        stop();
+        id_ = wheel_->schedule(secondsToTicks(seconds), std::move(onExpire));
+    }
+
+    void stop() {
+        if (id_ != 0) {
+            wheel_->cancel(id_);
+            id_ = 0;
+        }
+    }
+
+    bool isRunning() const { return id_ != 0 && wheel_->isPending(id_); }
+    bool hasExpired() const { return !isRunning(); }
+
+private:
+    TimerWheel* wheel_;
+    TimerWheel::TimerId id_ = 0;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstdint>
+#include "Animation.h"
+#include "TimerWheel.h"
+#include "Log.h"
+
+// One group of enemies of a level: count of kind, let in at perSecond once startSeconds
+// of play have passed. perSecond 0 lets the group in as fast as the scheduler allows.
+struct Wave {
+    float startSeconds = 0.f;
+    EnemyKind kind = EnemyKind::Slime;
+    int count = 0;
+    float perSecond = 0.f;
+};
+
+inline bool parseEnemyKind(std::string_view name, EnemyKind& kind) {
+    static const char* const names[] = { "slime", "goblin", "skeleton" };
+    for (size_t i = 0; i < static_cast<size_t>(EnemyKind::Count); ++i) {
+        if (name == names[i]) {
+            kind = static_cast<EnemyKind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// What a level throws at the player. Read from a text file next to the map
+// (map_2.dat -> map_2.waves), one setting per line, # starts a comment:
+//   max_alive <n>                                             enemies up at once
+//   wave <start seconds> <slime|goblin|skeleton> <count> <per second>
+struct WavePlan {
+    int maxAlive = 5;
+    std::vector<Wave> waves;
+
+    // The 5 enemies of one kind that every level had before wave files
+    static WavePlan standard(EnemyKind kind) {
+        WavePlan plan;
+        plan.waves.push_back({ 0.f, kind, 5, 0.f });
+        return plan;
+    }
+
+    int getTotalCount() const {
+        int total = 0;
+        for (const Wave& wave : waves) total += wave.count;
+        return total;
+    }
+
+    // Enemies up the moment the level starts, so their tiles can be rolled in advance
+    int getOpeningCount() const {
+        int opening = 0;
+        for (const Wave& wave : waves) {
+            if (wave.startSeconds <= 0.f && wave.perSecond <= 0.f) opening += wave.count;
+        }
+        return std::min(opening, maxAlive);
+    }
+
+    // False (and logged) when the file cannot be read or has a bad line
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            LOG_ERROR(LogCategory::Spawn, "Failed to open wave file {}", path);
+            return false;
+        }
+
+        WavePlan plan;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            std::string keyword;
+            if (!(fields >> keyword)) continue;
+
+            bool valid = false;
+            if (keyword == "max_alive") {
+                valid = static_cast<bool>(fields >> plan.maxAlive) && plan.maxAlive > 0;
+            } else if (keyword == "wave") {
+                Wave wave;
+                std::string kind;
+                valid = (fields >> wave.startSeconds >> kind >> wave.count >> wave.perSecond)
+                    && parseEnemyKind(kind, wave.kind)
+                    && wave.startSeconds >= 0.f && wave.count >= 0 && wave.perSecond >= 0.f;
+                if (valid) plan.waves.push_back(wave);
+            }
+            if (!valid) {
+                LOG_ERROR(LogCategory::Spawn, "{}:{}: bad wave line: {}", path, lineNumber, line);
+                return false;
+            }
+        }
+
+        *this = std::move(plan);
+        return true;
+    }
+};
+
+inline std::string wavePlanPathForMap(const std::string& mapFilename) {
+    return std::filesystem::path(mapFilename).replace_extension(".waves").generic_string();
+}
+
+// Lets a level's enemies in as its wave plan says, a few per tick. Runs inside the
+// simulation and counts ticks, not seconds, so it is as deterministic as the rest.
+//
+// A wave earns perSecond activations per second of play; what it has earned is spent
+// subject to the plan's max_alive and a per-tick cap shared by all waves, so a wave of
+// hundreds never lands in one frame. When a frame's work runs over the frame period the
+// rate and the cap shrink with the overload, and recover once frames fit again.
+class WaveScheduler {
+public:
+    static constexpr int MAX_ACTIVATIONS_PER_TICK = 8;
+    static constexpr double OVERLOADED = 1.1;       // Frame time over budget where scaling starts
+    static constexpr double MIN_RATE_SCALE = 0.1;   // Waves always finish, however slowly
+
+    void start(WavePlan plan) {
+        plan_ = std::move(plan);
+        credit_.assign(plan_.waves.size(), 0.0);
+        left_.clear();
+        for (const Wave& wave : plan_.waves) left_.push_back(wave.count);
+        remaining_ = plan_.getTotalCount();
+        ticks_ = 0;
+    }
+
+    const WavePlan& getPlan() const { return plan_; }
+    int getRemaining() const { return remaining_; }
+    bool isFinished() const { return remaining_ == 0; }
+
+    // How much of the normal spawn rate a frame load allows (work per frame / frame
+    // period, 0 if unknown)
+    static double rateScale(double frameLoad) {
+        if (frameLoad <= OVERLOADED) return 1.0;
+        return std::max(MIN_RATE_SCALE, OVERLOADED / frameLoad);
+    }
+
+    // One gameplay tick: calls activate(kind) for each enemy let in and returns how many.
+    // alive is how many enemies are up already.
+    template <typename Activate>
+    int update(int alive, double frameLoad, Activate activate) {
+        const float elapsed = static_cast<float>(ticks_) / SIM_TICK_RATE;
+        ++ticks_;
+        if (remaining_ == 0) return 0;
+
+        const double scale = rateScale(frameLoad);
+        int budget = std::max(1, static_cast<int>(MAX_ACTIVATIONS_PER_TICK * scale));
+        budget = std::min(budget, plan_.maxAlive - alive);
+        if (budget <= 0) return 0;
+
+        int activated = 0;
+        for (size_t i = 0; i < plan_.waves.size(); ++i) {
+            const Wave& wave = plan_.waves[i];
+            if (activated == budget) break;
+            if (left_[i] == 0 || wave.startSeconds > elapsed) continue;
+
+            // Credit does not pile up while the wave is held back, so it never bursts
+            double& credit = credit_[i];
+            credit = wave.perSecond > 0.f ? credit + wave.perSecond * scale / SIM_TICK_RATE : left_[i];
+            credit = std::min(credit, static_cast<double>(std::min(left_[i], MAX_ACTIVATIONS_PER_TICK)));
+
+            int count = std::min({ static_cast<int>(credit), left_[i], budget - activated });
+            for (int n = 0; n < count; ++n) activate(wave.kind);
+            credit -= count;
+            left_[i] -= count;
+            remaining_ -= count;
+            activated += count;
+        }
+        return activated;
+    }
+
+private:
+    WavePlan plan_;
+    std::vector<double> credit_;    // Activations earned but not spent, per wave
+    std::vector<int> left_;         // Not yet let in, per wave
+    int remaining_ = 0;
+    uint64_t ticks_ = 0;
+};
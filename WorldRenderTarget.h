@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <optional>
+#include <algorithm>
+#include <cmath>
+#include "Counters.h"
+
+// Draws the world into a texture 1/scale the size of the window and blits it up once with
+// nearest filtering, so the rasterizer fills scale^2 times fewer pixels (and the window
+// needs no multisampling). At scale 3 that is 427x240 for a 1280x720 window, the map's
+// own pixel grid: tiles come out exactly as before, the 2x character sprites are
+// resampled. Text and HUD still go straight to the window at full resolution.
+class WorldRenderTarget {
+public:
+    bool create(sf::Vector2u windowSize, unsigned int scale) {
+        scale_ = std::max(1u, scale);
+        sf::Vector2u size((windowSize.x + scale_ - 1) / scale_, (windowSize.y + scale_ - 1) / scale_);
+        if (!texture_.resize(size)) return false;
+        texture_.setSmooth(false);
+        sprite_.emplace(texture_.getTexture());
+        sprite_->setScale(sf::Vector2f(static_cast<float>(scale_), static_cast<float>(scale_)));
+        return true;
+    }
+
+    bool isActive() const { return sprite_.has_value(); }
+    unsigned int getScale() const { return scale_; }
+
+    // World-space rectangle the texture covers for this camera: the camera's centre,
+    // snapped to whole texture pixels so scrolling moves in steps of one native pixel
+    // instead of shimmering. Only reads what create() set, so any thread may ask.
+    sf::FloatRect snap(const sf::View& cameraView) const {
+        sf::Vector2f size(texture_.getSize() * scale_);
+        sf::Vector2f leftTop = cameraView.getCenter() - cameraView.getSize() / 2.f;
+        leftTop.x = std::round(leftTop.x / scale_) * scale_;
+        leftTop.y = std::round(leftTop.y / scale_) * scale_;
+        return sf::FloatRect(leftTop, size);
+    }
+
+    // Target for the world this frame
+    sf::RenderTarget& begin(const sf::View& cameraView, sf::Color clearColor) {
+        texture_.setView(sf::View(snap(cameraView)));
+        texture_.clear(clearColor);
+        return texture_;
+    }
+
+    // Upscales the finished world onto the window's top left corner
+    void present(sf::RenderTarget& window) {
+        texture_.display();
+        window.setView(window.getDefaultView());
+        window.draw(*sprite_);
+        COUNTER_ADD("draw calls", 1);
+    }
+
+private:
+    sf::RenderTexture texture_;
+    std::optional<sf::Sprite> sprite_;   // sf::Sprite needs a texture to exist
+    unsigned int scale_ = 1;
+};